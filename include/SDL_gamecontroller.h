@@ -842,6 +842,47 @@ extern DECLSPEC float SDLCALL SDL_GameControllerGetSensorDataRate(SDL_GameContro
  */
 extern DECLSPEC int SDLCALL SDL_GameControllerGetSensorData(SDL_GameController *gamecontroller, SDL_SensorType type, float *data, int num_values);
 
+/**
+ * A timestamped sample from a game controller sensor.
+ *
+ * \sa SDL_GameControllerGetSensorSamples
+ */
+typedef struct SDL_GameControllerSensorSample
+{
+    Uint64 timestamp_us;    /**< When the sample was taken, in microseconds */
+    float data[3];          /**< The sensor values, as described in SDL_sensor.h */
+} SDL_GameControllerSensorSample;
+
+/**
+ * Get the sensor samples a game controller has reported since the last call.
+ *
+ * Controllers like the PS5 and Nintendo Switch controllers report motion
+ * data at up to 1000 Hz, so SDL_GameControllerGetSensorData() only sees a
+ * fraction of the samples when the application polls once per frame. Each
+ * enabled sensor keeps a buffer of its most recent samples that this
+ * function drains, oldest first. If the buffer fills up, the oldest samples
+ * are discarded.
+ *
+ * Applications that use this function will usually want to turn off
+ * SDL_CONTROLLERSENSORUPDATE events with SDL_EventState().
+ *
+ * Timestamps are in microseconds on the same clock for all sensors, and can
+ * be compared to each other to find the time between samples.
+ *
+ * \param gamecontroller The controller to query
+ * \param type The type of sensor to query
+ * \param samples An array filled with the samples
+ * \param max_samples The number of elements in the samples array
+ * \returns the number of samples written, or -1 if an error occurred; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_GameControllerGetSensorData
+ * \sa SDL_GameControllerSetSensorEnabled
+ */
+extern DECLSPEC int SDLCALL SDL_GameControllerGetSensorSamples(SDL_GameController *gamecontroller, SDL_SensorType type, SDL_GameControllerSensorSample *samples, int max_samples);
+
 /**
  * Start a rumble effect on a game controller.
  *
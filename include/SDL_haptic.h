@@ -1128,6 +1128,56 @@ extern DECLSPEC int SDLCALL SDL_HapticRunEffect(SDL_Haptic * haptic,
                                                 int effect,
                                                 Uint32 iterations);
 
+/**
+ * Update the properties of several effects at once.
+ *
+ * This is the same as calling SDL_HapticUpdateEffect() for each effect, but
+ * checks all the effects before changing any of them. Effects whose
+ * properties haven't changed since they were last uploaded are skipped by
+ * backends that can detect it, avoiding a round trip to the device.
+ *
+ * \param haptic the SDL_Haptic device that has the effects
+ * \param effects an array of the IDs of the effects to update
+ * \param data an array of SDL_HapticEffect structures, one for each effect
+ * \param num_effects the number of effects to update
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_HapticRunEffects
+ * \sa SDL_HapticUpdateEffect
+ */
+extern DECLSPEC int SDLCALL SDL_HapticUpdateEffects(SDL_Haptic * haptic,
+                                                    const int *effects,
+                                                    SDL_HapticEffect * data,
+                                                    int num_effects);
+
+/**
+ * Run several haptic effects at once.
+ *
+ * This is the same as calling SDL_HapticRunEffect() for each effect, but
+ * backends that can start several effects in a single request to the device
+ * do so.
+ *
+ * \param haptic the SDL_Haptic device to run the effects on
+ * \param effects an array of the IDs of the effects to run
+ * \param num_effects the number of effects to run
+ * \param iterations the number of iterations to run the effects; use
+ *                   `SDL_HAPTIC_INFINITY` to repeat forever
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_HapticRunEffect
+ * \sa SDL_HapticUpdateEffects
+ */
+extern DECLSPEC int SDLCALL SDL_HapticRunEffects(SDL_Haptic * haptic,
+                                                 const int *effects,
+                                                 int num_effects,
+                                                 Uint32 iterations);
+
 /**
  * Stop the haptic effect on its associated haptic device.
  *
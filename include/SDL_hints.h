@@ -788,6 +788,21 @@ extern "C" {
  */
 #define SDL_HINT_JOYSTICK_HIDAPI_SWITCH_HOME_LED "SDL_JOYSTICK_HIDAPI_SWITCH_HOME_LED"
 
+/**
+ *  \brief  A variable controlling whether HIDAPI controller input is read on a separate thread.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Controller input is read in SDL_JoystickUpdate() (the default)
+ *    "1"       - Controller input is read on a thread per device as soon as it arrives
+ *
+ *  When the threads are used, reports are queued as they arrive, so none are lost when
+ *  the application pumps events slowly. The reports are still processed and events are
+ *  still sent in SDL_JoystickUpdate().
+ *
+ *  This hint should be set before SDL_Init() is called for joystick or game controller.
+ */
+#define SDL_HINT_JOYSTICK_HIDAPI_THREAD "SDL_JOYSTICK_HIDAPI_THREAD"
+
 /**
  *  \brief  A variable controlling whether the HIDAPI driver for XBox controllers should be used.
  *
@@ -891,6 +906,19 @@ extern "C" {
   */
 #define SDL_HINT_LINUX_JOYSTICK_DEADZONES "SDL_LINUX_JOYSTICK_DEADZONES"
 
+ /**
+  *  \brief  A variable controlling whether Linux joysticks are watched with epoll.
+  *
+  *  This variable can be set to the following values:
+  *    "0"       - Read every open joystick on each update (the default)
+  *    "1"       - Only read joysticks that have pending input, and only check for
+  *                added or removed devices when /dev/input changes
+  *
+  *  This is useful with many attached devices. This hint should be set before
+  *  joysticks are initialized.
+  */
+#define SDL_HINT_LINUX_JOYSTICK_EPOLL "SDL_LINUX_JOYSTICK_EPOLL"
+
 /**
 *  \brief  When set don't force the SDL app to become a foreground process
 *
@@ -976,6 +1004,17 @@ extern "C" {
  */
 #define SDL_HINT_MOUSE_RELATIVE_SPEED_SCALE    "SDL_MOUSE_RELATIVE_SPEED_SCALE"
 
+/**
+ *  \brief  A variable setting the acceleration for mouse motion, in floating point, when the mouse is in relative mode
+ *
+ *  Each motion report is scaled by (1 + acceleration * distance), where distance is the
+ *  length of the raw motion in device units. Fractional motion is carried over to the next
+ *  report, so slow movements aren't lost. The default is "0", which disables acceleration.
+ *
+ *  This hint is currently only used by the evdev input backend.
+ */
+#define SDL_HINT_MOUSE_RELATIVE_ACCELERATION    "SDL_MOUSE_RELATIVE_ACCELERATION"
+
 /**
  *  \brief  A variable controlling whether mouse events should generate synthetic touch events
  *
@@ -998,6 +1037,34 @@ extern "C" {
  */
 #define SDL_HINT_MOUSE_AUTO_CAPTURE    "SDL_MOUSE_AUTO_CAPTURE"
 
+/**
+ *  \brief  A variable controlling whether each mouse device has its own pointer
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - All mouse devices move the same pointer (default)
+ *    "1"       - Each mouse device moves its own pointer, reported with its own
+ *                mouse ID in the `which` field of mouse events
+ *
+ *  The first mouse device still drives the pointer returned by SDL_GetMouseState().
+ *  In relative mode all devices report to the application as a single mouse.
+ *
+ *  This hint is currently only used by the evdev input backend.
+ */
+#define SDL_HINT_MOUSE_MULTI_POINTER    "SDL_MOUSE_MULTI_POINTER"
+
+/**
+ *  \brief  A variable controlling how often SDL_MULTIGESTURE events are sent, in events per second per touch device
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - An SDL_MULTIGESTURE event is sent for every finger motion (default)
+ *    "N"       - Finger motion is accumulated and sent as at most N SDL_MULTIGESTURE
+ *                events per second per touch device, from SDL_PumpEvents()
+ *
+ *  The accumulated event carries the sum of the rotation and pinch deltas since the last
+ *  event was sent. A very large value sends one event per SDL_PumpEvents() call.
+ */
+#define SDL_HINT_MULTIGESTURE_RATE    "SDL_MULTIGESTURE_RATE"
+
 /**
  *  \brief Tell SDL not to catch the SIGINT or SIGTERM signals.
  *
@@ -405,6 +405,48 @@ extern DECLSPEC int SDLCALL SDL_JoystickSetVirtualButton(SDL_Joystick *joystick,
  */
 extern DECLSPEC int SDLCALL SDL_JoystickSetVirtualHat(SDL_Joystick *joystick, int hat, Uint8 value);
 
+/**
+ * A single input change in a virtual joystick playback script.
+ *
+ * \sa SDL_JoystickPlayVirtual
+ */
+typedef struct SDL_VirtualJoystickInput
+{
+    Uint32 type;    /**< SDL_JOYAXISMOTION, SDL_JOYBUTTONDOWN, SDL_JOYBUTTONUP or SDL_JOYHATMOTION */
+    Uint8 index;    /**< The axis, button or hat to change */
+    Sint16 value;   /**< The axis value or hat position, ignored for buttons */
+} SDL_VirtualJoystickInput;
+
+/**
+ * Play back a script of input changes on an opened virtual joystick.
+ *
+ * The inputs are applied in order at `rate` inputs per second, starting
+ * now. Playback is driven by SDL_JoystickUpdate(), which applies every input
+ * that came due since the previous update and reports each one, so none are
+ * lost when the application updates less often than the playback rate. If
+ * the application falls more than a second behind, the inputs in between
+ * are skipped.
+ *
+ * This is useful to generate input at a known rate without hardware, for
+ * example to measure the overhead of the input pipeline.
+ *
+ * The script is copied, and replaces any script that is already playing.
+ *
+ * \param joystick the virtual joystick on which to play the script.
+ * \param inputs the input changes to play, or NULL to stop playback.
+ * \param num_inputs the number of elements in the inputs array.
+ * \param rate the number of inputs to apply per second.
+ * \param loop SDL_TRUE to restart the script when it ends, SDL_FALSE to stop.
+ * \returns 0 on success, -1 on error.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_JoystickSetVirtualAxis
+ * \sa SDL_JoystickSetVirtualButton
+ * \sa SDL_JoystickSetVirtualHat
+ */
+extern DECLSPEC int SDLCALL SDL_JoystickPlayVirtual(SDL_Joystick *joystick, const SDL_VirtualJoystickInput *inputs, int num_inputs, int rate, SDL_bool loop);
+
 /**
  * Get the implementation dependent name of a joystick.
  *
@@ -375,6 +375,27 @@ extern DECLSPEC void SDLCALL SDL_SetCursor(SDL_Cursor * cursor);
  */
 extern DECLSPEC SDL_Cursor *SDLCALL SDL_GetCursor(void);
 
+/**
+ * Set the cursor shown for a single mouse device.
+ *
+ * When SDL_HINT_MOUSE_MULTI_POINTER is enabled, each mouse device has its own
+ * pointer position, and video backends that draw the cursor themselves draw
+ * one cursor per device. By default a device's pointer shows the active
+ * cursor set with SDL_SetCursor().
+ *
+ * \param mouseID the mouse device, as reported in the `which` field of mouse
+ *                events
+ * \param cursor the cursor to show for that device, or NULL to show the
+ *               active cursor
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_SetCursor
+ */
+extern DECLSPEC int SDLCALL SDL_SetCursorForMouse(Uint32 mouseID, SDL_Cursor * cursor);
+
 /**
  * Get the default cursor.
  *
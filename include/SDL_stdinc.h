@@ -459,11 +459,187 @@ extern DECLSPEC int SDLCALL SDL_SetMemoryFunctions(SDL_malloc_func malloc_func,
  */
 extern DECLSPEC int SDLCALL SDL_GetNumAllocations(void);
 
+/**
+ * The parts of SDL that allocation statistics are grouped by.
+ *
+ * Allocations made through the public memory functions, whether by the
+ * application or by SDL code that calls them indirectly, are counted as
+ * SDL_MEMORY_TAG_APPLICATION.
+ *
+ * \since This enum is available since SDL 2.24.0.
+ *
+ * \sa SDL_GetMemoryStats
+ */
+typedef enum
+{
+    SDL_MEMORY_TAG_OTHER,
+    SDL_MEMORY_TAG_APPLICATION,
+    SDL_MEMORY_TAG_EVENTS,
+    SDL_MEMORY_TAG_AUDIO,
+    SDL_MEMORY_TAG_RENDER,
+    SDL_MEMORY_TAG_VIDEO,
+    SDL_MEMORY_TAG_JOYSTICK,
+    SDL_NUM_MEMORY_TAGS
+} SDL_MemoryTag;
+
+/**
+ * Allocation counters for one SDL_MemoryTag.
+ *
+ * \since This struct is available since SDL 2.24.0.
+ */
+typedef struct SDL_MemoryTagStats
+{
+    Uint64 allocations;         /**< Allocations made, including reallocations */
+    Uint64 frees;               /**< Allocations freed, including reallocations */
+    Uint64 bytes_allocated;     /**< Total bytes allocated */
+    Uint64 bytes_in_use;        /**< Bytes currently allocated */
+    Uint64 peak_bytes_in_use;   /**< The most bytes allocated at once */
+} SDL_MemoryTagStats;
+
+/* Allocation sizes are counted in power of two buckets, up to this many */
+#define SDL_MEMORY_HISTOGRAM_BUCKETS    16
+
+/**
+ * Allocation statistics for all of SDL's memory functions.
+ *
+ * \since This struct is available since SDL 2.24.0.
+ *
+ * \sa SDL_GetMemoryStats
+ */
+typedef struct SDL_MemoryStats
+{
+    SDL_MemoryTagStats tags[SDL_NUM_MEMORY_TAGS];
+    Uint64 bytes_in_use;        /**< Bytes currently allocated */
+    Uint64 peak_bytes_in_use;   /**< The most bytes allocated at once */
+
+    /* Allocation counts by size: histogram[0] counts allocations of up to
+       16 bytes, histogram[1] up to 32 bytes and so on, and the last bucket
+       counts everything larger. */
+    Uint64 histogram[SDL_MEMORY_HISTOGRAM_BUCKETS];
+} SDL_MemoryStats;
+
+/**
+ * Allocation counters for one place in SDL that allocates memory.
+ *
+ * \since This struct is available since SDL 2.24.0.
+ *
+ * \sa SDL_GetMemorySites
+ */
+typedef struct SDL_MemorySiteStats
+{
+    const char *file;           /**< The source file of the call */
+    int line;                   /**< The line of the call */
+    SDL_MemoryTag tag;          /**< The part of SDL the file belongs to */
+    Uint64 allocations;         /**< Allocations made, including reallocations */
+    Uint64 bytes_allocated;     /**< Total bytes allocated */
+} SDL_MemorySiteStats;
+
+/**
+ * Get the allocation statistics that SDL has collected.
+ *
+ * Statistics are only collected when SDL is built with `SDL_MEMORY_STATS`
+ * defined to 1, since every allocation carries a small header in that case.
+ *
+ * \param stats a pointer filled in with the current statistics
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_GetMemorySites
+ * \sa SDL_ResetMemoryStats
+ */
+extern DECLSPEC int SDLCALL SDL_GetMemoryStats(SDL_MemoryStats *stats);
+
+/**
+ * Get the places in SDL that have allocated memory most often.
+ *
+ * \param sites an array filled in with the busiest sites first
+ * \param max_sites the number of elements in `sites`
+ * \returns the number of sites filled in on success or a negative error code
+ *          on failure; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_GetMemoryStats
+ */
+extern DECLSPEC int SDLCALL SDL_GetMemorySites(SDL_MemorySiteStats *sites, int max_sites);
+
+/**
+ * Reset the allocation counters, peaks and histogram.
+ *
+ * Bytes in use are kept, and become the new peaks, so that the statistics
+ * can be collected over a period such as a level of a game.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_GetMemoryStats
+ */
+extern DECLSPEC void SDLCALL SDL_ResetMemoryStats(void);
+
 extern DECLSPEC char *SDLCALL SDL_getenv(const char *name);
 extern DECLSPEC int SDLCALL SDL_setenv(const char *name, const char *value, int overwrite);
 
 extern DECLSPEC void SDLCALL SDL_qsort(void *base, size_t nmemb, size_t size, int (*compare) (const void *, const void *));
 
+/**
+ * A sort key and the index of the element it belongs to.
+ *
+ * \since This struct is available since SDL 2.24.0.
+ *
+ * \sa SDL_qsort_keys
+ */
+typedef struct SDL_SortKey
+{
+    Uint32 key;
+    Uint32 index;
+} SDL_SortKey;
+
+/**
+ * Sort an array of Uint32 values in ascending order.
+ *
+ * This is faster than SDL_qsort() because it doesn't call a comparison
+ * function.
+ *
+ * \param base the array to sort
+ * \param nmemb the number of elements in the array
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_qsort
+ */
+extern DECLSPEC void SDLCALL SDL_qsort_Uint32(Uint32 *base, size_t nmemb);
+
+/**
+ * Sort an array of float values in ascending order.
+ *
+ * -0.0 sorts before 0.0, and NaNs sort at the ends according to their sign.
+ *
+ * \param base the array to sort
+ * \param nmemb the number of elements in the array
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_qsort
+ */
+extern DECLSPEC void SDLCALL SDL_qsort_float(float *base, size_t nmemb);
+
+/**
+ * Sort an array of keys and indices by key.
+ *
+ * Elements with equal keys are ordered by index. To sort larger elements,
+ * fill in a key and the element's index for each one, sort the keys and then
+ * visit the elements in the order of the indices.
+ *
+ * \param base the array to sort
+ * \param nmemb the number of elements in the array
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_qsort
+ */
+extern DECLSPEC void SDLCALL SDL_qsort_keys(SDL_SortKey *base, size_t nmemb);
+
 extern DECLSPEC int SDLCALL SDL_abs(int x);
 
 /* NOTE: these double-evaluate their arguments, so you should never have side effects in the parameters */
@@ -555,6 +731,42 @@ extern DECLSPEC char *SDLCALL SDL_strstr(const char *haystack, const char *needl
 extern DECLSPEC char *SDLCALL SDL_strtokr(char *s1, const char *s2, char **saveptr);
 extern DECLSPEC size_t SDLCALL SDL_utf8strlen(const char *str);
 
+/**
+ * Count the number of codepoints in the first `bytes` bytes of a UTF-8
+ * string, stopping early at a NUL terminator.
+ *
+ * Like SDL_utf8strlen(), this counts the bytes that aren't continuation
+ * bytes and doesn't check that the string is valid.
+ *
+ * \param str the UTF-8 string to count
+ * \param bytes the maximum number of bytes to look at
+ * \returns the number of codepoints
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_utf8strlen
+ * \sa SDL_utf8valid
+ */
+extern DECLSPEC size_t SDLCALL SDL_utf8strnlen(const char *str, size_t bytes);
+
+/**
+ * Check how much of a buffer is valid UTF-8.
+ *
+ * Overlong encodings, surrogates, codepoints above U+10FFFF and sequences
+ * cut off by the end of the buffer are invalid. NUL bytes are valid.
+ *
+ * \param str the buffer to check
+ * \param bytes the size of the buffer, in bytes
+ * \returns the number of bytes at the start of the buffer that are complete
+ *          valid UTF-8 sequences; this is `bytes` if the whole buffer is
+ *          valid.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_utf8strnlen
+ */
+extern DECLSPEC size_t SDLCALL SDL_utf8valid(const char *str, size_t bytes);
+
 extern DECLSPEC char *SDLCALL SDL_itoa(int value, char *str, int radix);
 extern DECLSPEC char *SDLCALL SDL_uitoa(unsigned int value, char *str, int radix);
 extern DECLSPEC char *SDLCALL SDL_ltoa(long value, char *str, int radix);
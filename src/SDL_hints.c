@@ -21,13 +21,28 @@
 #include "./SDL_internal.h"
 
 #include "SDL_hints.h"
+#include "SDL_atomic.h"
 #include "SDL_error.h"
 #include "SDL_hints_c.h"
 
 
-/* Assuming there aren't many hints set and they aren't being queried in
-   critical performance paths, we'll just use linked lists here.
+/* Hints are kept in a hash table by name, and each one caches the parsed
+   forms of its value, so they can be queried in performance critical paths.
+
+   Environment variables override hints, and the application can change them
+   at any time, so every lookup reads the environment variable and compares
+   it with the copy the hint was last updated from.
+
+   Looking up a hint can add it to the table, so the table is protected
+   by a lock. Memory isn't allocated or freed and callbacks aren't called
+   while it's held, in case they query hints themselves.
  */
+#define SDL_HINT_BUCKETS    64
+
+#define HINT_PARSED_BOOLEAN 0x01
+#define HINT_PARSED_INT     0x02
+#define HINT_PARSED_FLOAT   0x04
+
 typedef struct SDL_HintWatch {
     SDL_HintCallback callback;
     void *userdata;
@@ -36,62 +51,213 @@ typedef struct SDL_HintWatch {
 
 typedef struct SDL_Hint {
     char *name;
+    Uint32 hash;
     char *value;
     SDL_HintPriority priority;
     SDL_HintWatch *callbacks;
+
+    /* A copy of the environment variable, and the value that SDL_GetHint()
+       returns, with its parsed forms */
+    char *env;
+    const char *current;
+    int parsed;
+    SDL_bool boolean_value;
+    int int_value;
+    float float_value;
+
     struct SDL_Hint *next;
 } SDL_Hint;
 
-static SDL_Hint *SDL_hints;
+/* A hint found with the lock held, and memory to free once it's released */
+typedef struct {
+    SDL_Hint *hint;
+    void *freeable[4];
+} SDL_LockedHint;
+
+static SDL_Hint *SDL_hints[SDL_HINT_BUCKETS];
+static SDL_SpinLock SDL_hints_lock;
+
+static Uint32
+SDL_HashHintName(const char *name)
+{
+    /* FNV-1a */
+    Uint32 hash = 2166136261u;
+    while (*name) {
+        hash ^= (Uint8)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/* This should be called with the lock held */
+static SDL_Hint *
+SDL_FindHint(const char *name, Uint32 hash)
+{
+    SDL_Hint *hint;
+
+    for (hint = SDL_hints[hash % SDL_HINT_BUCKETS]; hint; hint = hint->next) {
+        if (hint->hash == hash && SDL_strcmp(name, hint->name) == 0) {
+            break;
+        }
+    }
+    return hint;
+}
+
+static SDL_bool
+SDL_HintEnvMatches(const SDL_Hint *hint, const char *env)
+{
+    if (!env || !hint->env) {
+        return (!env && !hint->env) ? SDL_TRUE : SDL_FALSE;
+    }
+    return (SDL_strcmp(env, hint->env) == 0) ? SDL_TRUE : SDL_FALSE;
+}
+
+/* Work out what SDL_GetHint() returns, after the value, priority or
+   environment variable changes */
+static void
+SDL_UpdateHint(SDL_Hint *hint)
+{
+    if (hint->env && hint->priority != SDL_HINT_OVERRIDE) {
+        hint->current = hint->env;
+    } else {
+        hint->current = hint->value;
+    }
+    hint->parsed = 0;
+}
+
+static void
+SDL_UnlockHint(SDL_LockedHint *locked)
+{
+    int i;
+
+    SDL_AtomicUnlock(&SDL_hints_lock);
+
+    for (i = 0; i < SDL_arraysize(locked->freeable); ++i) {
+        SDL_free(locked->freeable[i]);
+    }
+}
+
+/* Find a hint, adding an entry for it if there isn't one yet, and return
+   with the lock held. Returns NULL without the lock if out of memory. */
+static SDL_Hint *
+SDL_LockHint(const char *name, SDL_LockedHint *locked)
+{
+    const Uint32 hash = SDL_HashHintName(name);
+    const char *env = SDL_getenv(name);
+    SDL_Hint *hint, *new_hint = NULL;
+    char *new_env = NULL;
+
+    SDL_zerop(locked);
+
+    SDL_AtomicLock(&SDL_hints_lock);
+    hint = SDL_FindHint(name, hash);
+    if (hint && SDL_HintEnvMatches(hint, env)) {
+        locked->hint = hint;
+        return hint;
+    }
+    SDL_AtomicUnlock(&SDL_hints_lock);
+
+    /* Allocate what we need to add or update the hint without the lock */
+    if (env) {
+        new_env = SDL_strdup(env);
+        if (!new_env) {
+            return NULL;
+        }
+    }
+    if (!hint) {
+        new_hint = (SDL_Hint *)SDL_calloc(1, sizeof(*new_hint));
+        if (new_hint) {
+            new_hint->name = SDL_strdup(name);
+        }
+        if (!new_hint || !new_hint->name) {
+            SDL_free(new_hint);
+            SDL_free(new_env);
+            return NULL;
+        }
+        new_hint->hash = hash;
+        new_hint->priority = SDL_HINT_DEFAULT;
+    }
+
+    /* Another thread may have gotten here first */
+    SDL_AtomicLock(&SDL_hints_lock);
+    hint = SDL_FindHint(name, hash);
+    if (!hint && new_hint) {
+        SDL_Hint **bucket = &SDL_hints[hash % SDL_HINT_BUCKETS];
+        hint = new_hint;
+        hint->next = *bucket;
+        *bucket = hint;
+        new_hint = NULL;
+    }
+    if (hint) {
+        if (!SDL_HintEnvMatches(hint, new_env)) {
+            locked->freeable[0] = hint->env;
+            hint->env = new_env;
+            new_env = NULL;
+        }
+        SDL_UpdateHint(hint);
+    }
+    locked->freeable[1] = new_env;
+    if (new_hint) {
+        locked->freeable[2] = new_hint->name;
+        locked->freeable[3] = new_hint;
+    }
+
+    if (!hint) {
+        /* The hints were cleared while the lock was released */
+        SDL_UnlockHint(locked);
+        return NULL;
+    }
+    locked->hint = hint;
+    return hint;
+}
 
 SDL_bool
 SDL_SetHintWithPriority(const char *name, const char *value,
                         SDL_HintPriority priority)
 {
-    const char *env;
+    SDL_LockedHint locked;
     SDL_Hint *hint;
     SDL_HintWatch *entry;
+    SDL_bool changed;
+    char *new_value = NULL;
+    char *old_value = NULL;
 
     if (!name || !value) {
         return SDL_FALSE;
     }
 
-    env = SDL_getenv(name);
-    if (env && priority < SDL_HINT_OVERRIDE) {
+    hint = SDL_LockHint(name, &locked);
+    if (!hint) {
         return SDL_FALSE;
     }
+    if ((hint->env && priority < SDL_HINT_OVERRIDE) ||
+        priority < hint->priority) {
+        SDL_UnlockHint(&locked);
+        return SDL_FALSE;
+    }
+    changed = (!hint->value || SDL_strcmp(hint->value, value) != 0);
+    SDL_UnlockHint(&locked);
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            if (priority < hint->priority) {
-                return SDL_FALSE;
-            }
-            if (!hint->value || !value || SDL_strcmp(hint->value, value) != 0) {
-                for (entry = hint->callbacks; entry; ) {
-                    /* Save the next entry in case this one is deleted */
-                    SDL_HintWatch *next = entry->next;
-                    entry->callback(entry->userdata, name, hint->value, value);
-                    entry = next;
-                }
-                SDL_free(hint->value);
-                hint->value = value ? SDL_strdup(value) : NULL;
-            }
-            hint->priority = priority;
-            return SDL_TRUE;
+    if (changed) {
+        for (entry = hint->callbacks; entry; ) {
+            /* Save the next entry in case this one is deleted */
+            SDL_HintWatch *next = entry->next;
+            entry->callback(entry->userdata, name, hint->value, value);
+            entry = next;
         }
+        new_value = SDL_strdup(value);
     }
 
-    /* Couldn't find the hint, add a new one */
-    hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
-    if (!hint) {
-        return SDL_FALSE;
+    SDL_AtomicLock(&SDL_hints_lock);
+    if (changed) {
+        old_value = hint->value;
+        hint->value = new_value;
     }
-    hint->name = SDL_strdup(name);
-    hint->value = value ? SDL_strdup(value) : NULL;
     hint->priority = priority;
-    hint->callbacks = NULL;
-    hint->next = SDL_hints;
-    SDL_hints = hint;
+    SDL_UpdateHint(hint);
+    SDL_AtomicUnlock(&SDL_hints_lock);
+
+    SDL_free(old_value);
     return SDL_TRUE;
 }
 
@@ -104,19 +270,20 @@ SDL_SetHint(const char *name, const char *value)
 const char *
 SDL_GetHint(const char *name)
 {
-    const char *env;
+    SDL_LockedHint locked;
     SDL_Hint *hint;
+    const char *value;
 
-    env = SDL_getenv(name);
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            if (!env || hint->priority == SDL_HINT_OVERRIDE) {
-                return hint->value;
-            }
-            break;
-        }
+    if (!name) {
+        return NULL;
+    }
+    hint = SDL_LockHint(name, &locked);
+    if (!hint) {
+        return SDL_getenv(name);
     }
-    return env;
+    value = hint->current;
+    SDL_UnlockHint(&locked);
+    return value;
 }
 
 SDL_bool
@@ -134,13 +301,92 @@ SDL_GetStringBoolean(const char *value, SDL_bool default_value)
 SDL_bool
 SDL_GetHintBoolean(const char *name, SDL_bool default_value)
 {
-    const char *hint = SDL_GetHint(name);
-    return SDL_GetStringBoolean(hint, default_value);
+    SDL_LockedHint locked;
+    SDL_Hint *hint;
+    SDL_bool retval;
+
+    if (!name) {
+        return default_value;
+    }
+    hint = SDL_LockHint(name, &locked);
+    if (!hint) {
+        return SDL_GetStringBoolean(SDL_getenv(name), default_value);
+    }
+    if (!hint->current || !*hint->current) {
+        retval = default_value;
+    } else {
+        if (!(hint->parsed & HINT_PARSED_BOOLEAN)) {
+            hint->boolean_value = SDL_GetStringBoolean(hint->current, default_value);
+            hint->parsed |= HINT_PARSED_BOOLEAN;
+        }
+        retval = hint->boolean_value;
+    }
+    SDL_UnlockHint(&locked);
+    return retval;
+}
+
+int
+SDL_GetHintInt(const char *name, int default_value)
+{
+    SDL_LockedHint locked;
+    SDL_Hint *hint;
+    const char *value;
+    int retval;
+
+    if (!name) {
+        return default_value;
+    }
+    hint = SDL_LockHint(name, &locked);
+    if (!hint) {
+        value = SDL_getenv(name);
+        return (value && *value) ? SDL_atoi(value) : default_value;
+    }
+    if (!hint->current || !*hint->current) {
+        retval = default_value;
+    } else {
+        if (!(hint->parsed & HINT_PARSED_INT)) {
+            hint->int_value = SDL_atoi(hint->current);
+            hint->parsed |= HINT_PARSED_INT;
+        }
+        retval = hint->int_value;
+    }
+    SDL_UnlockHint(&locked);
+    return retval;
+}
+
+float
+SDL_GetHintFloat(const char *name, float default_value)
+{
+    SDL_LockedHint locked;
+    SDL_Hint *hint;
+    const char *value;
+    float retval;
+
+    if (!name) {
+        return default_value;
+    }
+    hint = SDL_LockHint(name, &locked);
+    if (!hint) {
+        value = SDL_getenv(name);
+        return (value && *value) ? (float)SDL_atof(value) : default_value;
+    }
+    if (!hint->current || !*hint->current) {
+        retval = default_value;
+    } else {
+        if (!(hint->parsed & HINT_PARSED_FLOAT)) {
+            hint->float_value = (float)SDL_atof(hint->current);
+            hint->parsed |= HINT_PARSED_FLOAT;
+        }
+        retval = hint->float_value;
+    }
+    SDL_UnlockHint(&locked);
+    return retval;
 }
 
 void
 SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
 {
+    SDL_LockedHint locked;
     SDL_Hint *hint;
     SDL_HintWatch *entry;
     const char *value;
@@ -164,35 +410,17 @@ SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     entry->callback = callback;
     entry->userdata = userdata;
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            break;
-        }
-    }
+    hint = SDL_LockHint(name, &locked);
     if (!hint) {
-        /* Need to add a hint entry for this watcher */
-        hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
-        if (!hint) {
-            SDL_OutOfMemory();
-            SDL_free(entry);
-            return;
-        }
-        hint->name = SDL_strdup(name);
-        if (!hint->name) {
-            SDL_free(hint);
-            SDL_OutOfMemory();
-            return;
-        }
-        hint->value = NULL;
-        hint->priority = SDL_HINT_DEFAULT;
-        hint->callbacks = NULL;
-        hint->next = SDL_hints;
-        SDL_hints = hint;
+        SDL_OutOfMemory();
+        SDL_free(entry);
+        return;
     }
 
     /* Add it to the callbacks for this hint */
     entry->next = hint->callbacks;
     hint->callbacks = entry;
+    SDL_UnlockHint(&locked);
 
     /* Now call it with the current value */
     value = SDL_GetHint(name);
@@ -203,45 +431,60 @@ void
 SDL_DelHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
 {
     SDL_Hint *hint;
-    SDL_HintWatch *entry, *prev;
-
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            prev = NULL;
-            for (entry = hint->callbacks; entry; entry = entry->next) {
-                if (callback == entry->callback && userdata == entry->userdata) {
-                    if (prev) {
-                        prev->next = entry->next;
-                    } else {
-                        hint->callbacks = entry->next;
-                    }
-                    SDL_free(entry);
-                    break;
+    SDL_HintWatch *entry = NULL, *prev;
+
+    if (!name) {
+        return;
+    }
+    SDL_AtomicLock(&SDL_hints_lock);
+    hint = SDL_FindHint(name, SDL_HashHintName(name));
+    if (hint) {
+        prev = NULL;
+        for (entry = hint->callbacks; entry; entry = entry->next) {
+            if (callback == entry->callback && userdata == entry->userdata) {
+                if (prev) {
+                    prev->next = entry->next;
+                } else {
+                    hint->callbacks = entry->next;
                 }
-                prev = entry;
+                break;
             }
-            return;
+            prev = entry;
         }
     }
+    SDL_AtomicUnlock(&SDL_hints_lock);
+
+    SDL_free(entry);
 }
 
 void SDL_ClearHints(void)
 {
+    SDL_Hint *hints[SDL_HINT_BUCKETS];
     SDL_Hint *hint;
     SDL_HintWatch *entry;
+    int i;
 
-    while (SDL_hints) {
-        hint = SDL_hints;
-        SDL_hints = hint->next;
+    /* Take the hints out of the table, and free them without the lock */
+    SDL_AtomicLock(&SDL_hints_lock);
+    SDL_memcpy(hints, SDL_hints, sizeof(hints));
+    SDL_zeroa(SDL_hints);
+    SDL_AtomicUnlock(&SDL_hints_lock);
 
-        SDL_free(hint->name);
-        SDL_free(hint->value);
-        for (entry = hint->callbacks; entry; ) {
-            SDL_HintWatch *freeable = entry;
-            entry = entry->next;
-            SDL_free(freeable);
+    for (i = 0; i < SDL_HINT_BUCKETS; ++i) {
+        while (hints[i]) {
+            hint = hints[i];
+            hints[i] = hint->next;
+
+            SDL_free(hint->name);
+            SDL_free(hint->value);
+            SDL_free(hint->env);
+            for (entry = hint->callbacks; entry; ) {
+                SDL_HintWatch *freeable = entry;
+                entry = entry->next;
+                SDL_free(freeable);
+            }
+            SDL_free(hint);
         }
-        SDL_free(hint);
     }
 }
 
@@ -27,6 +27,10 @@
 
 extern SDL_bool SDL_GetStringBoolean(const char *value, SDL_bool default_value);
 
+/* Parsed hint values, cached until the hint or the environment changes */
+extern int SDL_GetHintInt(const char *name, int default_value);
+extern float SDL_GetHintFloat(const char *name, float default_value);
+
 #endif /* SDL_hints_c_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
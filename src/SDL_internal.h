@@ -124,6 +124,25 @@
 #include "SDL_assert.h"
 #include "SDL_log.h"
 
+/* Allocation statistics
+   - a header on every allocation with its size and tag
+   - SDL's own allocations are tagged with their call site */
+#ifndef SDL_MEMORY_STATS
+#define SDL_MEMORY_STATS                0
+#endif
+
+#if SDL_MEMORY_STATS && !defined(__clang_analyzer__)
+extern void *SDL_TaggedMalloc(size_t size, const char *file, int line);
+extern void *SDL_TaggedCalloc(size_t nmemb, size_t size, const char *file, int line);
+extern void *SDL_TaggedRealloc(void *ptr, size_t size, const char *file, int line);
+#undef SDL_malloc
+#undef SDL_calloc
+#undef SDL_realloc
+#define SDL_malloc(size)            SDL_TaggedMalloc(size, __FILE__, __LINE__)
+#define SDL_calloc(nmemb, size)     SDL_TaggedCalloc(nmemb, size, __FILE__, __LINE__)
+#define SDL_realloc(ptr, size)      SDL_TaggedRealloc(ptr, size, __FILE__, __LINE__)
+#endif
+
 #endif /* SDL_internal_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
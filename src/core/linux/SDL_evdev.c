@@ -99,6 +99,15 @@ typedef struct SDL_evdevlist_item
     SDL_bool high_res_wheel;
     SDL_bool high_res_hwheel;
 
+    /* Relative motion collected until the next SYN_REPORT, and the sub-pixel
+       remainder left over after acceleration */
+    int mouse_dx, mouse_dy;
+    float mouse_accum_x, mouse_accum_y;
+
+    /* The mouse ID used when SDL_HINT_MOUSE_MULTI_POINTER is set */
+    SDL_bool is_mouse;
+    SDL_MouseID mouse_id;
+
     struct SDL_evdevlist_item *next;
 } SDL_evdevlist_item;
 
@@ -109,6 +118,8 @@ typedef struct SDL_EVDEV_PrivateData
     SDL_evdevlist_item *first;
     SDL_evdevlist_item *last;
     SDL_EVDEV_keyboard_state *kbd;
+    float relative_acceleration;
+    SDL_MouseID next_mouse_id;
 } SDL_EVDEV_PrivateData;
 
 #undef _THIS
@@ -143,6 +154,48 @@ SDL_EVDEV_SetRelativeMouseMode(SDL_bool enabled)
     return 0;
 }
 
+static void SDLCALL
+SDL_EVDEV_RelativeAccelerationChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    if (hint && *hint) {
+        _this->relative_acceleration = SDL_max((float)SDL_atof(hint), 0.0f);
+    } else {
+        _this->relative_acceleration = 0.0f;
+    }
+}
+
+/* Send the REL_X/REL_Y motion of one report as a single event. In relative
+   mode the raw deltas are used directly, so no warping is ever needed. */
+static void
+SDL_EVDEV_send_mouse_motion(SDL_evdevlist_item *item, SDL_Mouse *mouse, SDL_MouseID mouse_id)
+{
+    int dx = item->mouse_dx;
+    int dy = item->mouse_dy;
+
+    if (!dx && !dy) {
+        return;
+    }
+    item->mouse_dx = 0;
+    item->mouse_dy = 0;
+
+    if (mouse->relative_mode && _this->relative_acceleration > 0.0f) {
+        const float speed = SDL_sqrtf((float)(dx * dx + dy * dy));
+        const float scale = 1.0f + _this->relative_acceleration * speed;
+
+        item->mouse_accum_x += dx * scale;
+        item->mouse_accum_y += dy * scale;
+        dx = (int)item->mouse_accum_x;
+        dy = (int)item->mouse_accum_y;
+        item->mouse_accum_x -= dx;
+        item->mouse_accum_y -= dy;
+        if (!dx && !dy) {
+            return;
+        }
+    }
+
+    SDL_SendMouseMotion(mouse->focus, mouse_id, SDL_TRUE, dx, dy);
+}
+
 
 int
 SDL_EVDEV_Init(void)
@@ -175,6 +228,8 @@ SDL_EVDEV_Init(void)
 #endif /* SDL_USE_LIBUDEV */
 
         _this->kbd = SDL_EVDEV_kbd_init();
+
+        SDL_AddHintCallback(SDL_HINT_MOUSE_RELATIVE_ACCELERATION, SDL_EVDEV_RelativeAccelerationChanged, NULL);
     }
 
     SDL_GetMouse()->SetRelativeMouseMode = SDL_EVDEV_SetRelativeMouseMode;
@@ -194,6 +249,8 @@ SDL_EVDEV_Quit(void)
     _this->ref_count -= 1;
 
     if (_this->ref_count < 1) {
+        SDL_DelHintCallback(SDL_HINT_MOUSE_RELATIVE_ACCELERATION, SDL_EVDEV_RelativeAccelerationChanged, NULL);
+
 #if SDL_USE_LIBUDEV
         SDL_UDEV_DelCallback(SDL_EVDEV_udev_callback);
         SDL_UDEV_Quit();
@@ -255,6 +312,7 @@ SDL_EVDEV_Poll(void)
     SDL_Scancode scan_code;
     int mouse_button;
     SDL_Mouse *mouse;
+    SDL_MouseID mouse_id;
     float norm_x, norm_y, norm_pressure;
 
     if (!_this) {
@@ -268,6 +326,8 @@ SDL_EVDEV_Poll(void)
     mouse = SDL_GetMouse();
 
     for (item = _this->first; item != NULL; item = item->next) {
+        mouse_id = mouse->multi_pointer ? item->mouse_id : mouse->mouseID;
+
         while ((len = read(item->fd, events, (sizeof events))) > 0) {
             len /= sizeof(events[0]);
             for (i = 0; i < len; ++i) {
@@ -283,9 +343,9 @@ SDL_EVDEV_Poll(void)
                     if (events[i].code >= BTN_MOUSE && events[i].code < BTN_MOUSE + SDL_arraysize(EVDEV_MouseButtons)) {
                         mouse_button = events[i].code - BTN_MOUSE;
                         if (events[i].value == 0) {
-                            SDL_SendMouseButton(mouse->focus, mouse->mouseID, SDL_RELEASED, EVDEV_MouseButtons[mouse_button]);
+                            SDL_SendMouseButton(mouse->focus, mouse_id, SDL_RELEASED, EVDEV_MouseButtons[mouse_button]);
                         } else if (events[i].value == 1) {
-                            SDL_SendMouseButton(mouse->focus, mouse->mouseID, SDL_PRESSED, EVDEV_MouseButtons[mouse_button]);
+                            SDL_SendMouseButton(mouse->focus, mouse_id, SDL_PRESSED, EVDEV_MouseButtons[mouse_button]);
                         }
                         break;
                     }
@@ -379,26 +439,26 @@ SDL_EVDEV_Poll(void)
                 case EV_REL:
                     switch(events[i].code) {
                     case REL_X:
-                        SDL_SendMouseMotion(mouse->focus, mouse->mouseID, SDL_TRUE, events[i].value, 0);
+                        item->mouse_dx += events[i].value;
                         break;
                     case REL_Y:
-                        SDL_SendMouseMotion(mouse->focus, mouse->mouseID, SDL_TRUE, 0, events[i].value);
+                        item->mouse_dy += events[i].value;
                         break;
                     case REL_WHEEL:
                         if (!item->high_res_wheel)
-                            SDL_SendMouseWheel(mouse->focus, mouse->mouseID, 0, events[i].value, SDL_MOUSEWHEEL_NORMAL);
+                            SDL_SendMouseWheel(mouse->focus, mouse_id, 0, events[i].value, SDL_MOUSEWHEEL_NORMAL);
                         break;
                     case REL_WHEEL_HI_RES:
                         SDL_assert(item->high_res_wheel);
-                        SDL_SendMouseWheel(mouse->focus, mouse->mouseID, 0, events[i].value / 120.0f, SDL_MOUSEWHEEL_NORMAL);
+                        SDL_SendMouseWheel(mouse->focus, mouse_id, 0, events[i].value / 120.0f, SDL_MOUSEWHEEL_NORMAL);
                         break;
                     case REL_HWHEEL:
                         if (!item->high_res_hwheel)
-                            SDL_SendMouseWheel(mouse->focus, mouse->mouseID, events[i].value, 0, SDL_MOUSEWHEEL_NORMAL);
+                            SDL_SendMouseWheel(mouse->focus, mouse_id, events[i].value, 0, SDL_MOUSEWHEEL_NORMAL);
                         break;
                     case REL_HWHEEL_HI_RES:
                         SDL_assert(item->high_res_hwheel);
-                        SDL_SendMouseWheel(mouse->focus, mouse->mouseID, events[i].value / 120.0f, 0, SDL_MOUSEWHEEL_NORMAL);
+                        SDL_SendMouseWheel(mouse->focus, mouse_id, events[i].value / 120.0f, 0, SDL_MOUSEWHEEL_NORMAL);
                         break;
                     default:
                         break;
@@ -407,6 +467,8 @@ SDL_EVDEV_Poll(void)
                 case EV_SYN:
                     switch (events[i].code) {
                     case SYN_REPORT:
+                        SDL_EVDEV_send_mouse_motion(item, mouse, mouse_id);
+
                         if (!item->is_touchscreen) /* FIXME: temp hack */
                             break;
 
@@ -450,6 +512,9 @@ SDL_EVDEV_Poll(void)
                             item->out_of_sync = 0;
                         break;
                     case SYN_DROPPED:
+                        /* The rest of this report was lost, don't apply half of it */
+                        item->mouse_dx = 0;
+                        item->mouse_dy = 0;
                         if (item->is_touchscreen)
                             item->out_of_sync = 1;
                         SDL_EVDEV_sync_device(item);
@@ -727,6 +792,20 @@ SDL_EVDEV_sync_device(SDL_evdevlist_item *item)
 }
 
 #if SDL_USE_LIBUDEV
+static SDL_evdevlist_item *
+SDL_EVDEV_find_main_mouse(void)
+{
+    SDL_MouseID main_id = SDL_GetMouse()->mouseID;
+    SDL_evdevlist_item *item;
+
+    for (item = _this->first; item != NULL; item = item->next) {
+        if (item->is_mouse && item->mouse_id == main_id) {
+            return item;
+        }
+    }
+    return NULL;
+}
+
 static int
 SDL_EVDEV_device_added(const char *dev_path, int udev_class)
 {
@@ -764,6 +843,16 @@ SDL_EVDEV_device_added(const char *dev_path, int udev_class)
         item->high_res_hwheel = test_bit(REL_HWHEEL_HI_RES, relbit);
     }
 
+    if (udev_class & SDL_UDEV_DEVICE_MOUSE) {
+        /* One mouse drives the main pointer in multi-pointer mode, the rest get their own IDs */
+        item->is_mouse = SDL_TRUE;
+        if (SDL_EVDEV_find_main_mouse() != NULL) {
+            item->mouse_id = ++_this->next_mouse_id;
+        } else {
+            item->mouse_id = SDL_GetMouse()->mouseID;
+        }
+    }
+
     if (udev_class & SDL_UDEV_DEVICE_TOUCHSCREEN) {
         item->is_touchscreen = 1;
 
@@ -809,6 +898,16 @@ SDL_EVDEV_device_removed(const char *dev_path)
             if (item->is_touchscreen) {
                 SDL_EVDEV_destroy_touchscreen(item);
             }
+            if (item->is_mouse && item->mouse_id == SDL_GetMouse()->mouseID) {
+                /* Hand the main pointer to a remaining mouse, if there is one */
+                SDL_evdevlist_item *mouse_item;
+                for (mouse_item = _this->first; mouse_item != NULL; mouse_item = mouse_item->next) {
+                    if (mouse_item->is_mouse) {
+                        mouse_item->mouse_id = item->mouse_id;
+                        break;
+                    }
+                }
+            }
             close(item->fd);
             SDL_free(item->path);
             SDL_free(item);
@@ -40,6 +40,7 @@
 
 #include "SDL_cpuinfo.h"
 #include "SDL_assert.h"
+#include "SDL_cpuinfo_c.h"
 
 #ifdef HAVE_SYSCONF
 #include <unistd.h>
@@ -112,6 +113,7 @@
 #define CPU_HAS_NEON    (1 << 11)
 #define CPU_HAS_AVX512F (1 << 12)
 #define CPU_HAS_ARM_SIMD (1 << 13)
+#define CPU_HAS_PCLMULQDQ (1 << 14)
 
 #if SDL_ALTIVEC_BLITTERS && HAVE_SETJMP && !__MACOSX__ && !__OpenBSD__ && !__FreeBSD__
 /* This is the brute force way of detecting instruction sets...
@@ -571,6 +573,11 @@ CPU_have3DNow(void)
 #else
 #define CPU_haveAVX() (0)
 #endif
+#if defined(__PCLMUL__)
+#define CPU_havePCLMULQDQ() (1)
+#else
+#define CPU_havePCLMULQDQ() (0)
+#endif
 #else
 #define CPU_haveRDTSC() (CPU_CPUIDFeatures[3] & 0x00000010)
 #define CPU_haveMMX() (CPU_CPUIDFeatures[3] & 0x00800000)
@@ -580,6 +587,7 @@ CPU_have3DNow(void)
 #define CPU_haveSSE41() (CPU_CPUIDFeatures[2] & 0x00080000)
 #define CPU_haveSSE42() (CPU_CPUIDFeatures[2] & 0x00100000)
 #define CPU_haveAVX() (CPU_OSSavesYMM && (CPU_CPUIDFeatures[2] & 0x10000000))
+#define CPU_havePCLMULQDQ() (CPU_CPUIDFeatures[2] & 0x00000002)
 #endif
 
 #if defined(__e2k__)
@@ -885,6 +893,9 @@ SDL_GetCPUFeatures(void)
             SDL_CPUFeatures |= CPU_HAS_NEON;
             SDL_SIMDAlignment = SDL_max(SDL_SIMDAlignment, 16);
         }
+        if (CPU_havePCLMULQDQ()) {
+            SDL_CPUFeatures |= CPU_HAS_PCLMULQDQ;
+        }
     }
     return SDL_CPUFeatures;
 }
@@ -974,6 +985,12 @@ SDL_HasNEON(void)
     return CPU_FEATURE_AVAILABLE(CPU_HAS_NEON);
 }
 
+SDL_bool
+SDL_HasPCLMULQDQ(void)
+{
+    return CPU_FEATURE_AVAILABLE(CPU_HAS_PCLMULQDQ);
+}
+
 static int SDL_SystemRAM = 0;
 
 int
@@ -865,3 +865,16 @@
 #define SDL_EncloseFPoints SDL_EncloseFPoints_REAL
 #define SDL_IntersectFRectAndLine SDL_IntersectFRectAndLine_REAL
 #define SDL_RenderGetWindow SDL_RenderGetWindow_REAL
+#define SDL_SetCursorForMouse SDL_SetCursorForMouse_REAL
+#define SDL_GameControllerGetSensorSamples SDL_GameControllerGetSensorSamples_REAL
+#define SDL_JoystickPlayVirtual SDL_JoystickPlayVirtual_REAL
+#define SDL_HapticUpdateEffects SDL_HapticUpdateEffects_REAL
+#define SDL_HapticRunEffects SDL_HapticRunEffects_REAL
+#define SDL_GetMemoryStats SDL_GetMemoryStats_REAL
+#define SDL_GetMemorySites SDL_GetMemorySites_REAL
+#define SDL_ResetMemoryStats SDL_ResetMemoryStats_REAL
+#define SDL_qsort_Uint32 SDL_qsort_Uint32_REAL
+#define SDL_qsort_float SDL_qsort_float_REAL
+#define SDL_qsort_keys SDL_qsort_keys_REAL
+#define SDL_utf8strnlen SDL_utf8strnlen_REAL
+#define SDL_utf8valid SDL_utf8valid_REAL
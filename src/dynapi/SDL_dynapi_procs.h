@@ -936,3 +936,16 @@ SDL_DYNAPI_PROC(void,SDL_UnionFRect,(const SDL_FRect *a, const SDL_FRect *b, SDL
 SDL_DYNAPI_PROC(SDL_bool,SDL_EncloseFPoints,(const SDL_FPoint *a, int b, const SDL_FRect *c, SDL_FRect *d),(a,b,c,d),return)
 SDL_DYNAPI_PROC(SDL_bool,SDL_IntersectFRectAndLine,(const SDL_FRect *a, float *b, float *c, float *d, float *e),(a,b,c,d,e),return)
 SDL_DYNAPI_PROC(SDL_Window*,SDL_RenderGetWindow,(SDL_Renderer *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_SetCursorForMouse,(Uint32 a, SDL_Cursor *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_GameControllerGetSensorSamples,(SDL_GameController *a, SDL_SensorType b, SDL_GameControllerSensorSample *c, int d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_JoystickPlayVirtual,(SDL_Joystick *a, const SDL_VirtualJoystickInput *b, int c, int d, SDL_bool e),(a,b,c,d,e),return)
+SDL_DYNAPI_PROC(int,SDL_HapticUpdateEffects,(SDL_Haptic *a, const int *b, SDL_HapticEffect *c, int d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_HapticRunEffects,(SDL_Haptic *a, const int *b, int c, Uint32 d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_GetMemoryStats,(SDL_MemoryStats *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_GetMemorySites,(SDL_MemorySiteStats *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(void,SDL_ResetMemoryStats,(void),(),)
+SDL_DYNAPI_PROC(void,SDL_qsort_Uint32,(Uint32 *a, size_t b),(a,b),)
+SDL_DYNAPI_PROC(void,SDL_qsort_float,(float *a, size_t b),(a,b),)
+SDL_DYNAPI_PROC(void,SDL_qsort_keys,(SDL_SortKey *a, size_t b),(a,b),)
+SDL_DYNAPI_PROC(size_t,SDL_utf8strnlen,(const char *a, size_t b),(a,b),return)
+SDL_DYNAPI_PROC(size_t,SDL_utf8valid,(const char *a, size_t b),(a,b),return)
@@ -847,6 +847,9 @@ SDL_PumpEventsInternal(SDL_bool push_sentinel)
         _this->PumpEvents(_this);
     }
 
+    /* Send any multi-finger gestures accumulated since the last pump */
+    SDL_GesturePumpEvents();
+
 #if !SDL_JOYSTICK_DISABLED
     /* Check for joystick state change */
     if (SDL_update_joysticks) {
@@ -25,9 +25,20 @@
 
 #include "SDL_events.h"
 #include "SDL_endian.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_hints.h"
+#include "SDL_timer.h"
 #include "SDL_events_c.h"
 #include "SDL_gesture_c.h"
 
+#ifdef __SSE__
+#define HAVE_SSE_INTRINSICS 1
+#endif
+
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
+
 /*
 #include <stdio.h>
 */
@@ -59,6 +70,9 @@ typedef struct {
 typedef struct {
     SDL_FloatPoint path[DOLLARNPOINTS];
     unsigned long hash;
+    /* Distance of each point from the origin. Rotation doesn't change these,
+       so they give a cheap lower bound on the difference at any angle. */
+    float radius[DOLLARNPOINTS];
 } SDL_DollarTemplate;
 
 typedef struct {
@@ -71,11 +85,58 @@ typedef struct {
     SDL_DollarTemplate *dollarTemplate;
 
     SDL_bool recording;
+
+    /* Multi-finger motion accumulated since the last SDL_MULTIGESTURE event */
+    SDL_bool multiPending;
+    float multiDTheta;
+    float multiDDist;
+    Uint32 multiLastTicks;
 } SDL_GestureTouch;
 
 static SDL_GestureTouch *SDL_gestureTouch;
 static int SDL_numGestureTouches = 0;
+static SDL_TouchIDMap SDL_gestureTouchMap;
 static SDL_bool recordAll;
+static int SDL_multiGestureRate = 0;
+
+static SDL_GestureTouch * SDL_GetGestureTouch(SDL_TouchID id)
+{
+    int i = SDL_TouchIDMapFind(&SDL_gestureTouchMap, id);
+    if (i < 0) {
+        return NULL;
+    }
+    return &SDL_gestureTouch[i];
+}
+
+static void SDL_ResetGestureMulti(SDL_GestureTouch* touch)
+{
+    touch->multiDTheta = 0;
+    touch->multiDDist = 0;
+    touch->multiPending = SDL_FALSE;
+}
+
+static void SDL_FlushGestureMulti(SDL_GestureTouch* touch);
+
+static void SDLCALL
+SDL_MultiGestureRateChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    int rate = (hint && *hint) ? SDL_atoi(hint) : 0;
+    int i;
+
+    SDL_multiGestureRate = SDL_max(rate, 0);
+
+    /* Events are sent right away again, send anything waiting to be sent */
+    if (SDL_multiGestureRate == 0) {
+        for (i = 0; i < SDL_numGestureTouches; i++) {
+            SDL_FlushGestureMulti(&SDL_gestureTouch[i]);
+        }
+    }
+}
+
+void SDL_GestureInit()
+{
+    SDL_AddHintCallback(SDL_HINT_MULTIGESTURE_RATE, SDL_MultiGestureRateChanged, NULL);
+}
 
 #if 0
 static void PrintPath(SDL_FloatPoint *path)
@@ -105,8 +166,10 @@ int SDL_RecordGesture(SDL_TouchID touchId)
 
 void SDL_GestureQuit()
 {
+    SDL_DelHintCallback(SDL_HINT_MULTIGESTURE_RATE, SDL_MultiGestureRateChanged, NULL);
     SDL_free(SDL_gestureTouch);
     SDL_gestureTouch = NULL;
+    SDL_TouchIDMapFree(&SDL_gestureTouchMap);
 }
 
 static unsigned long SDL_HashDollar(SDL_FloatPoint* points)
@@ -182,6 +245,14 @@ int SDL_SaveDollarTemplate(SDL_GestureID gestureId, SDL_RWops *dst)
     return SDL_SetError("Unknown gestureId");
 }
 
+static void dollarRadii(const SDL_FloatPoint *points, float *radius)
+{
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        radius[i] = (float)SDL_sqrt(points[i].x*points[i].x + points[i].y*points[i].y);
+    }
+}
+
 /* path is an already sampled set of points
 Returns the index of the gesture on success, or -1 */
 static int SDL_AddDollarGesture_one(SDL_GestureTouch* inTouch, SDL_FloatPoint* path)
@@ -203,6 +274,7 @@ static int SDL_AddDollarGesture_one(SDL_GestureTouch* inTouch, SDL_FloatPoint* p
     templ = &inTouch->dollarTemplate[index];
     SDL_memcpy(templ->path, path, DOLLARNPOINTS*sizeof(SDL_FloatPoint));
     templ->hash = SDL_HashDollar(templ->path);
+    dollarRadii(templ->path, templ->radius);
     inTouch->numDollarTemplates++;
 
     return index;
@@ -232,11 +304,7 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
     SDL_GestureTouch *touch = NULL;
     if (src == NULL) return 0;
     if (touchId >= 0) {
-        for (i = 0; i < SDL_numGestureTouches; i++) {
-            if (SDL_gestureTouch[i].id == touchId) {
-                touch = &SDL_gestureTouch[i];
-            }
-        }
+        touch = SDL_GetGestureTouch(touchId);
         if (touch == NULL) {
             return SDL_SetError("given touch id not found");
         }
@@ -282,20 +350,109 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
 
 
 #if defined(ENABLE_DOLLAR)
-static float dollarDifference(SDL_FloatPoint* points,SDL_FloatPoint* templ,float ang)
+#if HAVE_SSE_INTRINSICS
+static float dollarDifference_SSE(const SDL_FloatPoint* points,const SDL_FloatPoint* templ,float c,float s)
+{
+    const __m128 vc = _mm_set1_ps(c);
+    const __m128 vs = _mm_set1_ps(s);
+    __m128 sum = _mm_setzero_ps();
+    float result[4];
+    int i;
+
+    /* DOLLARNPOINTS is a multiple of 4, so there are no leftovers. */
+    for (i = 0; i < DOLLARNPOINTS; i += 4) {
+        const __m128 p01 = _mm_loadu_ps(&points[i].x);
+        const __m128 p23 = _mm_loadu_ps(&points[i+2].x);
+        const __m128 t01 = _mm_loadu_ps(&templ[i].x);
+        const __m128 t23 = _mm_loadu_ps(&templ[i+2].x);
+        const __m128 px = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 py = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1));
+        const __m128 tx = _mm_shuffle_ps(t01, t23, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 ty = _mm_shuffle_ps(t01, t23, _MM_SHUFFLE(3, 1, 3, 1));
+        const __m128 dx = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(px, vc), _mm_mul_ps(py, vs)), tx);
+        const __m128 dy = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(px, vs), _mm_mul_ps(py, vc)), ty);
+        sum = _mm_add_ps(sum, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))));
+    }
+    _mm_storeu_ps(result, sum);
+    return (result[0] + result[1] + result[2] + result[3]) / DOLLARNPOINTS;
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+static float dollarDifference_NEON(const SDL_FloatPoint* points,const SDL_FloatPoint* templ,float c,float s)
+{
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    float result[4];
+    int i;
+
+    for (i = 0; i < DOLLARNPOINTS; i += 4) {
+        const float32x4x2_t p = vld2q_f32(&points[i].x);
+        const float32x4x2_t t = vld2q_f32(&templ[i].x);
+        const float32x4_t dx = vsubq_f32(vmlsq_n_f32(vmulq_n_f32(p.val[0], c), p.val[1], s), t.val[0]);
+        const float32x4_t dy = vsubq_f32(vmlaq_n_f32(vmulq_n_f32(p.val[1], c), p.val[0], s), t.val[1]);
+        const float32x4_t d2 = vmlaq_f32(vmulq_f32(dx, dx), dy, dy);
+        /* No vsqrtq_f32 on ARMv7; refine the reciprocal square root estimate instead. */
+        float32x4_t rsqrt = vrsqrteq_f32(d2);
+        rsqrt = vmulq_f32(rsqrt, vrsqrtsq_f32(vmulq_f32(d2, rsqrt), rsqrt));
+        rsqrt = vmulq_f32(rsqrt, vrsqrtsq_f32(vmulq_f32(d2, rsqrt), rsqrt));
+        /* d2 * 1/sqrt(d2) is NaN when d2 is zero, so mask those lanes out. */
+        sum = vaddq_f32(sum, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(d2, rsqrt)),
+                                                             vcgtq_f32(d2, vdupq_n_f32(0.0f)))));
+    }
+    vst1q_f32(result, sum);
+    return (result[0] + result[1] + result[2] + result[3]) / DOLLARNPOINTS;
+}
+#endif
+
+static float dollarDifference_Scalar(const SDL_FloatPoint* points,const SDL_FloatPoint* templ,float c,float s)
 {
-    /*  SDL_FloatPoint p[DOLLARNPOINTS]; */
     float dist = 0;
     SDL_FloatPoint p;
     int i;
     for (i = 0; i < DOLLARNPOINTS; i++) {
-        p.x = (float)(points[i].x * SDL_cos(ang) - points[i].y * SDL_sin(ang));
-        p.y = (float)(points[i].x * SDL_sin(ang) + points[i].y * SDL_cos(ang));
+        p.x = points[i].x * c - points[i].y * s;
+        p.y = points[i].x * s + points[i].y * c;
         dist += (float)(SDL_sqrt((p.x-templ[i].x)*(p.x-templ[i].x)+
                                  (p.y-templ[i].y)*(p.y-templ[i].y)));
     }
     return dist/DOLLARNPOINTS;
+}
+
+typedef float (*SDL_DollarDifferenceFunc)(const SDL_FloatPoint*,const SDL_FloatPoint*,float,float);
+static SDL_DollarDifferenceFunc dollarDifferenceFunc = NULL;
 
+static float dollarDifference(SDL_FloatPoint* points,SDL_FloatPoint* templ,float ang)
+{
+    if (!dollarDifferenceFunc) {
+#if HAVE_SSE_INTRINSICS
+        if (SDL_HasSSE()) {
+            dollarDifferenceFunc = dollarDifference_SSE;
+        }
+#endif
+#if HAVE_NEON_INTRINSICS
+        if (!dollarDifferenceFunc && SDL_HasNEON()) {
+            dollarDifferenceFunc = dollarDifference_NEON;
+        }
+#endif
+        if (!dollarDifferenceFunc) {
+            dollarDifferenceFunc = dollarDifference_Scalar;
+        }
+    }
+    /* The rotation is the same for every point, so only compute it once. */
+    return dollarDifferenceFunc(points, templ, (float)SDL_cos(ang), (float)SDL_sin(ang));
+}
+
+/* Lower bound of dollarDifference() over all angles: rotating a point doesn't
+   change its distance from the origin, so by the triangle inequality each
+   point is at least ||p| - |t|| away from its template point. */
+static float dollarLowerBound(const float* pointRadius,const float* templRadius)
+{
+    float dist = 0;
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        dist += SDL_fabsf(pointRadius[i] - templRadius[i]);
+    }
+    return dist/DOLLARNPOINTS;
 }
 
 static float bestDollarDifference(SDL_FloatPoint* points,SDL_FloatPoint* templ)
@@ -434,17 +591,24 @@ static int dollarNormalize(const SDL_DollarPath *path,SDL_FloatPoint *points, SD
 static float dollarRecognize(const SDL_DollarPath *path,int *bestTempl,SDL_GestureTouch* touch)
 {
     SDL_FloatPoint points[DOLLARNPOINTS];
+    float radius[DOLLARNPOINTS];
     int i;
     float bestDiff = 10000;
 
     SDL_memset(points, 0, sizeof(points));
 
     dollarNormalize(path, points, SDL_FALSE);
+    dollarRadii(points, radius);
 
     /* PrintPath(points); */
     *bestTempl = -1;
     for (i = 0; i < touch->numDollarTemplates; i++) {
-        float diff = bestDollarDifference(points,touch->dollarTemplate[i].path);
+        float diff;
+        /* Skip the golden section search if this template can't beat the best one */
+        if (dollarLowerBound(radius,touch->dollarTemplate[i].radius) >= bestDiff) {
+            continue;
+        }
+        diff = bestDollarDifference(points,touch->dollarTemplate[i].path);
         if (diff < bestDiff) {bestDiff = diff; *bestTempl = i;}
     }
     return bestDiff;
@@ -463,6 +627,10 @@ int SDL_GestureAddTouch(SDL_TouchID touchId)
 
     SDL_gestureTouch = gestureTouch;
 
+    if (SDL_TouchIDMapSet(&SDL_gestureTouchMap, touchId, SDL_numGestureTouches) < 0) {
+        return -1;
+    }
+
     SDL_zero(SDL_gestureTouch[SDL_numGestureTouches]);
     SDL_gestureTouch[SDL_numGestureTouches].id = touchId;
     SDL_numGestureTouches++;
@@ -471,38 +639,25 @@ int SDL_GestureAddTouch(SDL_TouchID touchId)
 
 int SDL_GestureDelTouch(SDL_TouchID touchId)
 {
-    int i;
-    for (i = 0; i < SDL_numGestureTouches; i++) {
-        if (SDL_gestureTouch[i].id == touchId) {
-            break;
-        }
-    }
+    int i = SDL_TouchIDMapFind(&SDL_gestureTouchMap, touchId);
 
-    if (i == SDL_numGestureTouches) {
+    if (i < 0) {
         /* not found */
         return -1;
     }
 
     SDL_free(SDL_gestureTouch[i].dollarTemplate);
     SDL_zero(SDL_gestureTouch[i]);
+    SDL_TouchIDMapRemove(&SDL_gestureTouchMap, touchId);
 
     SDL_numGestureTouches--;
     if (i != SDL_numGestureTouches) {
         SDL_memcpy(&SDL_gestureTouch[i], &SDL_gestureTouch[SDL_numGestureTouches], sizeof(SDL_gestureTouch[i]));
+        SDL_TouchIDMapSet(&SDL_gestureTouchMap, SDL_gestureTouch[i].id, i);
     }
     return 0;
 }
 
-static SDL_GestureTouch * SDL_GetGestureTouch(SDL_TouchID id)
-{
-    int i;
-    for (i = 0; i < SDL_numGestureTouches; i++) {
-        /* printf("%i ?= %i\n",SDL_gestureTouch[i].id,id); */
-        if (SDL_gestureTouch[i].id == id)
-            return &SDL_gestureTouch[i];
-    }
-    return NULL;
-}
 
 static void SDL_SendGestureMulti(SDL_GestureTouch* touch,float dTheta,float dDist)
 {
@@ -519,6 +674,49 @@ static void SDL_SendGestureMulti(SDL_GestureTouch* touch,float dTheta,float dDis
     }
 }
 
+static void SDL_FlushGestureMulti(SDL_GestureTouch* touch)
+{
+    if (touch->multiPending) {
+        SDL_SendGestureMulti(touch,touch->multiDTheta,touch->multiDDist);
+    }
+    SDL_ResetGestureMulti(touch);
+}
+
+static void SDL_AccumulateGestureMulti(SDL_GestureTouch* touch,float dTheta,float dDist)
+{
+    if (SDL_multiGestureRate == 0) {
+        SDL_SendGestureMulti(touch,dTheta,dDist);
+        return;
+    }
+    touch->multiDTheta += dTheta;
+    touch->multiDDist += dDist;
+    touch->multiPending = SDL_TRUE;
+}
+
+void SDL_GesturePumpEvents(void)
+{
+    Uint32 now, interval;
+    int i;
+
+    if (SDL_multiGestureRate == 0) {
+        return;
+    }
+
+    now = SDL_GetTicks();
+    interval = 1000 / SDL_multiGestureRate;
+    for (i = 0; i < SDL_numGestureTouches; i++) {
+        SDL_GestureTouch* touch = &SDL_gestureTouch[i];
+        if (!touch->multiPending) {
+            continue;
+        }
+        if (interval && !SDL_TICKS_PASSED(now, touch->multiLastTicks + interval)) {
+            continue;
+        }
+        SDL_FlushGestureMulti(touch);
+        touch->multiLastTicks = now;
+    }
+}
+
 #if defined(ENABLE_DOLLAR)
 static void SDL_SendGestureDollar(SDL_GestureTouch* touch,
                           SDL_GestureID gestureId,float error)
@@ -582,6 +780,11 @@ void SDL_GestureProcessEvent(SDL_Event* event)
             SDL_FloatPoint path[DOLLARNPOINTS];
 #endif
 
+            /* The multi-finger gesture is over, send what's left of it */
+            if (inTouch->numDownFingers <= 2) {
+                SDL_FlushGestureMulti(inTouch);
+            }
+
             inTouch->numDownFingers--;
 
 #if defined(ENABLE_DOLLAR)
@@ -683,7 +886,7 @@ void SDL_GestureProcessEvent(SDL_Event* event)
                 knob.ang += dtheta;
                 printf("thetaSum = %f, distSum = %f\n",gdtheta,gdDist);
                 printf("id: %i dTheta = %f, dDist = %f\n",j,dtheta,dDist); */
-                SDL_SendGestureMulti(inTouch,dtheta,dDist);
+                SDL_AccumulateGestureMulti(inTouch,dtheta,dDist);
             }
             else {
                 /* inTouch->gestureLast[j].dDist = 0;
@@ -23,11 +23,15 @@
 #ifndef SDL_gesture_c_h_
 #define SDL_gesture_c_h_
 
+extern void SDL_GestureInit(void);
+
 extern int SDL_GestureAddTouch(SDL_TouchID touchId);
 extern int SDL_GestureDelTouch(SDL_TouchID touchId);
 
 extern void SDL_GestureProcessEvent(SDL_Event* event);
 
+extern void SDL_GesturePumpEvents(void);
+
 extern void SDL_GestureQuit(void);
 
 #endif /* SDL_gesture_c_h_ */
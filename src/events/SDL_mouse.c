@@ -46,6 +46,8 @@ static SDL_bool track_mouse_down = SDL_FALSE;
 
 static int
 SDL_PrivateSendMouseMotion(SDL_Window * window, SDL_MouseID mouseID, int relative, int x, int y);
+static SDL_MouseInputSource *GetMouseInputSource(SDL_Mouse *mouse, SDL_MouseID mouseID);
+static int GetScaledMouseDelta(float scale, int value, float *accum);
 
 static void SDLCALL
 SDL_MouseDoubleClickTimeChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
@@ -161,6 +163,14 @@ SDL_MouseAutoCaptureChanged(void *userdata, const char *name, const char *oldVal
     }
 }
 
+static void SDLCALL
+SDL_MouseMultiPointerChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SDL_Mouse *mouse = (SDL_Mouse *)userdata;
+
+    mouse->multi_pointer = SDL_GetStringBoolean(hint, SDL_FALSE);
+}
+
 /* Public functions */
 int
 SDL_MouseInit(void)
@@ -195,6 +205,9 @@ SDL_MouseInit(void)
     SDL_AddHintCallback(SDL_HINT_MOUSE_AUTO_CAPTURE,
                         SDL_MouseAutoCaptureChanged, mouse);
 
+    SDL_AddHintCallback(SDL_HINT_MOUSE_MULTI_POINTER,
+                        SDL_MouseMultiPointerChanged, mouse);
+
     mouse->was_touch_mouse_events = SDL_FALSE; /* no touch to mouse movement event pending */
 
     mouse->cursor_shown = SDL_TRUE;
@@ -315,9 +328,78 @@ SDL_UpdateMouseFocus(SDL_Window * window, int x, int y, Uint32 buttonstate, SDL_
     return SDL_TRUE;
 }
 
+/* Secondary mice have their own pointer when SDL_HINT_MOUSE_MULTI_POINTER is set */
+static SDL_bool
+IsSecondaryPointer(SDL_Mouse *mouse, SDL_MouseID mouseID)
+{
+    return (mouse->multi_pointer && !mouse->relative_mode &&
+            mouseID != mouse->mouseID && mouseID != SDL_TOUCH_MOUSEID);
+}
+
+static int
+SDL_PrivateSendPointerMotion(SDL_Window * window, SDL_MouseID mouseID, int relative, int x, int y)
+{
+    SDL_Mouse *mouse = SDL_GetMouse();
+    SDL_MouseInputSource *source = GetMouseInputSource(mouse, mouseID);
+    int xrel, yrel;
+    int posted;
+
+    if (!source) {
+        return 0;
+    }
+
+    /* New pointers start where the main pointer is */
+    if (!source->has_position) {
+        source->x = mouse->x;
+        source->y = mouse->y;
+        source->has_position = SDL_TRUE;
+    }
+
+    if (relative) {
+        x = GetScaledMouseDelta(mouse->normal_speed_scale, x, &source->scale_accum_x);
+        y = GetScaledMouseDelta(mouse->normal_speed_scale, y, &source->scale_accum_y);
+        x += source->x;
+        y += source->y;
+    }
+
+    if (window) {
+        int w = 0, h = 0;
+        SDL_GetWindowSize(window, &w, &h);
+        x = SDL_clamp(x, 0, w - 1);
+        y = SDL_clamp(y, 0, h - 1);
+    }
+
+    xrel = x - source->x;
+    yrel = y - source->y;
+    if (!xrel && !yrel) {
+        return 0;
+    }
+    source->x = x;
+    source->y = y;
+
+    posted = 0;
+    if (SDL_GetEventState(SDL_MOUSEMOTION) == SDL_ENABLE) {
+        SDL_Event event;
+        event.motion.type = SDL_MOUSEMOTION;
+        event.motion.windowID = mouse->focus ? mouse->focus->id : 0;
+        event.motion.which = mouseID;
+        event.motion.state = source->buttonstate;
+        event.motion.x = x;
+        event.motion.y = y;
+        event.motion.xrel = xrel;
+        event.motion.yrel = yrel;
+        posted = (SDL_PushEvent(&event) > 0);
+    }
+    return posted;
+}
+
 int
 SDL_SendMouseMotion(SDL_Window * window, SDL_MouseID mouseID, int relative, int x, int y)
 {
+    if (IsSecondaryPointer(SDL_GetMouse(), mouseID)) {
+        return SDL_PrivateSendPointerMotion(window, mouseID, relative, x, y);
+    }
+
     if (window && !relative) {
         SDL_Mouse *mouse = SDL_GetMouse();
         if (!SDL_UpdateMouseFocus(window, x, y, GetButtonState(mouse), (mouseID == SDL_TOUCH_MOUSEID) ? SDL_FALSE : SDL_TRUE)) {
@@ -527,8 +609,8 @@ static SDL_MouseInputSource *GetMouseInputSource(SDL_Mouse *mouse, SDL_MouseID m
         mouse->sources = sources;
         ++mouse->num_sources;
         source = &sources[mouse->num_sources - 1];
+        SDL_zerop(source);
         source->mouseID = mouseID;
-        source->buttonstate = 0;
         return source;
     }
     return NULL;
@@ -650,8 +732,13 @@ SDL_PrivateSendMouseButton(SDL_Window * window, SDL_MouseID mouseID, Uint8 state
         event.button.state = state;
         event.button.button = button;
         event.button.clicks = (Uint8) SDL_min(clicks, 255);
-        event.button.x = mouse->x;
-        event.button.y = mouse->y;
+        if (source->has_position && IsSecondaryPointer(mouse, mouseID)) {
+            event.button.x = source->x;
+            event.button.y = source->y;
+        } else {
+            event.button.x = mouse->x;
+            event.button.y = mouse->y;
+        }
         posted = (SDL_PushEvent(&event) > 0);
     }
 
@@ -810,6 +897,9 @@ SDL_MouseQuit(void)
 
     SDL_DelHintCallback(SDL_HINT_MOUSE_AUTO_CAPTURE,
                         SDL_MouseAutoCaptureChanged, mouse);
+
+    SDL_DelHintCallback(SDL_HINT_MOUSE_MULTI_POINTER,
+                        SDL_MouseMultiPointerChanged, mouse);
 }
 
 Uint32
@@ -1220,11 +1310,39 @@ SDL_GetDefaultCursor(void)
     return mouse->def_cursor;
 }
 
+int
+SDL_SetCursorForMouse(Uint32 mouseID, SDL_Cursor * cursor)
+{
+    SDL_Mouse *mouse = SDL_GetMouse();
+    SDL_MouseInputSource *source;
+
+    if (cursor) {
+        SDL_Cursor *found;
+
+        for (found = mouse->cursors; found; found = found->next) {
+            if (found == cursor) {
+                break;
+            }
+        }
+        if (!found && cursor != mouse->def_cursor) {
+            return SDL_SetError("Cursor not associated with the current mouse");
+        }
+    }
+
+    source = GetMouseInputSource(mouse, mouseID);
+    if (!source) {
+        return SDL_OutOfMemory();
+    }
+    source->cursor = cursor;
+    return 0;
+}
+
 void
 SDL_FreeCursor(SDL_Cursor * cursor)
 {
     SDL_Mouse *mouse = SDL_GetMouse();
     SDL_Cursor *curr, *prev;
+    int i;
 
     if (!cursor) {
         return;
@@ -1236,6 +1354,11 @@ SDL_FreeCursor(SDL_Cursor * cursor)
     if (cursor == mouse->cur_cursor) {
         SDL_SetCursor(mouse->def_cursor);
     }
+    for (i = 0; i < mouse->num_sources; ++i) {
+        if (mouse->sources[i].cursor == cursor) {
+            mouse->sources[i].cursor = NULL;
+        }
+    }
 
     for (prev = NULL, curr = mouse->cursors; curr;
          prev = curr, curr = curr->next) {
@@ -37,6 +37,14 @@ typedef struct
 {
     SDL_MouseID mouseID;
     Uint32 buttonstate;
+
+    /* Pointer state for secondary mice when SDL_HINT_MOUSE_MULTI_POINTER is set */
+    SDL_bool has_position;
+    int x;
+    int y;
+    SDL_Cursor *cursor;     /* NULL to use cur_cursor */
+    float scale_accum_x;
+    float scale_accum_y;
 } SDL_MouseInputSource;
 
 typedef struct
@@ -104,6 +112,7 @@ typedef struct
     Uint8 vita_touch_mouse_device;
 #endif
     SDL_bool auto_capture;
+    SDL_bool multi_pointer;
     SDL_bool capture_desired;
     SDL_Window *capture_window;
 
@@ -29,6 +29,7 @@
 
 static int SDL_num_touch = 0;
 static SDL_Touch **SDL_touchDevices = NULL;
+static SDL_TouchIDMap SDL_touchMap;
 
 /* for mapping touch events to mice */
 
@@ -40,10 +41,130 @@ static SDL_FingerID track_fingerid;
 static SDL_TouchID  track_touchid;
 #endif
 
+#define SDL_TOUCHIDMAP_MINSIZE 16
+
+static SDL_INLINE int
+SDL_TouchIDMapBucket(const SDL_TouchIDMap *map, Sint64 id)
+{
+    /* IDs are often small sequential numbers or pointers, so mix the bits */
+    Uint32 hash = (Uint32)id ^ (Uint32)((Uint64)id >> 32);
+    hash *= 0x9E3779B1u;
+    return (int)(hash ^ (hash >> 16)) & (map->size - 1);
+}
+
+int
+SDL_TouchIDMapFind(const SDL_TouchIDMap *map, Sint64 id)
+{
+    int i;
+
+    if (map->count == 0) {
+        return -1;
+    }
+    for (i = SDL_TouchIDMapBucket(map, id); map->slots[i] >= 0; i = (i + 1) & (map->size - 1)) {
+        if (map->ids[i] == id) {
+            return map->slots[i];
+        }
+    }
+    return -1;
+}
+
+static int
+SDL_TouchIDMapResize(SDL_TouchIDMap *map, int size)
+{
+    SDL_TouchIDMap resized;
+    int i;
+
+    resized.ids = (Sint64 *)SDL_calloc(size, sizeof(*resized.ids));
+    resized.slots = (int *)SDL_malloc(size * sizeof(*resized.slots));
+    if (!resized.ids || !resized.slots) {
+        SDL_free(resized.ids);
+        SDL_free(resized.slots);
+        return SDL_OutOfMemory();
+    }
+    resized.size = size;
+    resized.count = 0;
+    for (i = 0; i < size; ++i) {
+        resized.slots[i] = -1;
+    }
+    for (i = 0; i < map->size; ++i) {
+        if (map->slots[i] >= 0) {
+            SDL_TouchIDMapSet(&resized, map->ids[i], map->slots[i]);
+        }
+    }
+    SDL_TouchIDMapFree(map);
+    *map = resized;
+    return 0;
+}
+
+int
+SDL_TouchIDMapSet(SDL_TouchIDMap *map, Sint64 id, int slot)
+{
+    int i;
+
+    /* Keep the load factor at or below one half so probe sequences stay short */
+    if ((map->count + 1) * 2 > map->size) {
+        if (SDL_TouchIDMapResize(map, map->size ? map->size * 2 : SDL_TOUCHIDMAP_MINSIZE) < 0) {
+            return -1;
+        }
+    }
+
+    for (i = SDL_TouchIDMapBucket(map, id); map->slots[i] >= 0; i = (i + 1) & (map->size - 1)) {
+        if (map->ids[i] == id) {
+            map->slots[i] = slot;
+            return 0;
+        }
+    }
+    map->ids[i] = id;
+    map->slots[i] = slot;
+    ++map->count;
+    return 0;
+}
+
+void
+SDL_TouchIDMapRemove(SDL_TouchIDMap *map, Sint64 id)
+{
+    int mask = map->size - 1;
+    int i, j;
+
+    if (map->count == 0) {
+        return;
+    }
+    for (i = SDL_TouchIDMapBucket(map, id); map->ids[i] != id; i = (i + 1) & mask) {
+        if (map->slots[i] < 0) {
+            return;
+        }
+    }
+    if (map->slots[i] < 0) {
+        return;
+    }
+
+    /* Shift later entries of the probe sequence back so lookups don't stop early */
+    for (j = (i + 1) & mask; map->slots[j] >= 0; j = (j + 1) & mask) {
+        int k = SDL_TouchIDMapBucket(map, map->ids[j]);
+        if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j)) {
+            continue;
+        }
+        map->ids[i] = map->ids[j];
+        map->slots[i] = map->slots[j];
+        i = j;
+    }
+    map->slots[i] = -1;
+    --map->count;
+}
+
+void
+SDL_TouchIDMapFree(SDL_TouchIDMap *map)
+{
+    SDL_free(map->ids);
+    SDL_free(map->slots);
+    SDL_zerop(map);
+}
+
 /* Public functions */
 int
 SDL_TouchInit(void)
 {
+    SDL_GestureInit();
     return (0);
 }
 
@@ -76,16 +197,7 @@ SDL_GetTouchName(int index)
 static int
 SDL_GetTouchIndex(SDL_TouchID id)
 {
-    int index;
-    SDL_Touch *touch;
-
-    for (index = 0; index < SDL_num_touch; ++index) {
-        touch = SDL_touchDevices[index];
-        if (touch->id == id) {
-            return index;
-        }
-    }
-    return -1;
+    return SDL_TouchIDMapFind(&SDL_touchMap, id);
 }
 
 SDL_Touch *
@@ -117,13 +229,7 @@ SDL_GetTouchDeviceType(SDL_TouchID id)
 static int
 SDL_GetFingerIndex(const SDL_Touch * touch, SDL_FingerID fingerid)
 {
-    int index;
-    for (index = 0; index < touch->num_fingers; ++index) {
-        if (touch->fingers[index]->id == fingerid) {
-            return index;
-        }
-    }
-    return -1;
+    return SDL_TouchIDMapFind(&touch->finger_map, fingerid);
 }
 
 static SDL_Finger *
@@ -181,11 +287,16 @@ SDL_AddTouch(SDL_TouchID touchID, SDL_TouchDeviceType type, const char *name)
     SDL_touchDevices = touchDevices;
     index = SDL_num_touch;
 
-    SDL_touchDevices[index] = (SDL_Touch *) SDL_malloc(sizeof(*SDL_touchDevices[index]));
+    SDL_touchDevices[index] = (SDL_Touch *) SDL_calloc(1, sizeof(*SDL_touchDevices[index]));
     if (!SDL_touchDevices[index]) {
         return SDL_OutOfMemory();
     }
 
+    if (SDL_TouchIDMapSet(&SDL_touchMap, touchID, index) < 0) {
+        SDL_free(SDL_touchDevices[index]);
+        return -1;
+    }
+
     /* Added touch to list */
     ++SDL_num_touch;
 
@@ -223,6 +334,10 @@ SDL_AddFinger(SDL_Touch *touch, SDL_FingerID fingerid, float x, float y, float p
         touch->max_fingers++;
     }
 
+    if (SDL_TouchIDMapSet(&touch->finger_map, fingerid, touch->num_fingers) < 0) {
+        return -1;
+    }
+
     finger = touch->fingers[touch->num_fingers++];
     finger->id = fingerid;
     finger->x = x;
@@ -241,10 +356,16 @@ SDL_DelFinger(SDL_Touch* touch, SDL_FingerID fingerid)
         return -1;
     }
 
+    SDL_TouchIDMapRemove(&touch->finger_map, fingerid);
+
     touch->num_fingers--;
     temp = touch->fingers[index];
     touch->fingers[index] = touch->fingers[touch->num_fingers];
     touch->fingers[touch->num_fingers] = temp;
+    if (index != touch->num_fingers) {
+        /* Can't fail, the finger is already in the map */
+        SDL_TouchIDMapSet(&touch->finger_map, touch->fingers[index]->id, index);
+    }
     return 0;
 }
 
@@ -468,11 +589,16 @@ SDL_DelTouch(SDL_TouchID id)
         SDL_free(touch->fingers[i]);
     }
     SDL_free(touch->fingers);
+    SDL_TouchIDMapFree(&touch->finger_map);
     SDL_free(touch->name);
     SDL_free(touch);
 
+    SDL_TouchIDMapRemove(&SDL_touchMap, id);
     SDL_num_touch--;
     SDL_touchDevices[index] = SDL_touchDevices[SDL_num_touch];
+    if (index != SDL_num_touch) {
+        SDL_TouchIDMapSet(&SDL_touchMap, SDL_touchDevices[index]->id, index);
+    }
 
     /* Delete this touch device for gestures */
     SDL_GestureDelTouch(id);
@@ -490,6 +616,7 @@ SDL_TouchQuit(void)
 
     SDL_free(SDL_touchDevices);
     SDL_touchDevices = NULL;
+    SDL_TouchIDMapFree(&SDL_touchMap);
     SDL_GestureQuit();
 }
 
@@ -24,6 +24,16 @@
 #ifndef SDL_touch_c_h_
 #define SDL_touch_c_h_
 
+/* Open addressed map from a touch or finger ID to its slot in an array,
+   so that lookups on every touch event don't scan the whole array. */
+typedef struct SDL_TouchIDMap
+{
+    Sint64 *ids;
+    int *slots;     /* -1 marks an empty bucket */
+    int size;       /* number of buckets, always a power of two */
+    int count;
+} SDL_TouchIDMap;
+
 typedef struct SDL_Touch
 {
     SDL_TouchID id;
@@ -31,10 +41,24 @@ typedef struct SDL_Touch
     int num_fingers;
     int max_fingers;
     SDL_Finger** fingers;
+    SDL_TouchIDMap finger_map;
     char *name;
 } SDL_Touch;
 
 
+/* Get the slot for an ID, or -1 if it isn't in the map */
+extern int SDL_TouchIDMapFind(const SDL_TouchIDMap *map, Sint64 id);
+
+/* Add or update the slot for an ID, returning 0 on success or -1 if out of memory */
+extern int SDL_TouchIDMapSet(SDL_TouchIDMap *map, Sint64 id, int slot);
+
+/* Remove an ID from the map */
+extern void SDL_TouchIDMapRemove(SDL_TouchIDMap *map, Sint64 id);
+
+/* Free the memory used by the map */
+extern void SDL_TouchIDMapFree(SDL_TouchIDMap *map);
+
+
 /* Initialize the touch subsystem */
 extern int SDL_TouchInit(void);
 
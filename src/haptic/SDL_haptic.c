@@ -566,6 +566,76 @@ SDL_HapticRunEffect(SDL_Haptic * haptic, int effect, Uint32 iterations)
     return 0;
 }
 
+/*
+ * Updates several effects, after checking that all of them can be updated.
+ */
+int
+SDL_HapticUpdateEffects(SDL_Haptic * haptic, const int *effects,
+                        SDL_HapticEffect * data, int num_effects)
+{
+    int i;
+
+    if (!ValidHaptic(haptic)) {
+        return -1;
+    }
+    if (num_effects < 0) {
+        return SDL_InvalidParamError("num_effects");
+    }
+    if (num_effects > 0 && (!effects || !data)) {
+        return SDL_InvalidParamError(!effects ? "effects" : "data");
+    }
+
+    for (i = 0; i < num_effects; ++i) {
+        if (!ValidEffect(haptic, effects[i])) {
+            return -1;
+        }
+        /* Can't change type dynamically. */
+        if (data[i].type != haptic->effects[effects[i]].effect.type) {
+            return SDL_SetError("Haptic: Updating effect type is illegal.");
+        }
+    }
+
+    for (i = 0; i < num_effects; ++i) {
+        if (SDL_SYS_HapticUpdateEffect(haptic, &haptic->effects[effects[i]], &data[i]) < 0) {
+            return -1;
+        }
+        SDL_memcpy(&haptic->effects[effects[i]].effect, &data[i],
+                   sizeof(SDL_HapticEffect));
+    }
+    return 0;
+}
+
+/*
+ * Runs several haptic effects on the device.
+ */
+int
+SDL_HapticRunEffects(SDL_Haptic * haptic, const int *effects, int num_effects,
+                     Uint32 iterations)
+{
+    int i;
+
+    if (!ValidHaptic(haptic)) {
+        return -1;
+    }
+    if (num_effects < 0) {
+        return SDL_InvalidParamError("num_effects");
+    }
+    if (num_effects == 0) {
+        return 0;
+    }
+    if (!effects) {
+        return SDL_InvalidParamError("effects");
+    }
+
+    for (i = 0; i < num_effects; ++i) {
+        if (!ValidEffect(haptic, effects[i])) {
+            return -1;
+        }
+    }
+
+    return SDL_SYS_HapticRunEffects(haptic, effects, num_effects, iterations);
+}
+
 /*
  * Stops the haptic effect on the device.
  */
@@ -145,6 +145,16 @@ extern int SDL_SYS_HapticRunEffect(SDL_Haptic * haptic,
                                    struct haptic_effect *effect,
                                    Uint32 iterations);
 
+/*
+ * Runs several effects on the haptic device, given as indices into
+ * haptic->effects. The indices have already been validated.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+extern int SDL_SYS_HapticRunEffects(SDL_Haptic * haptic,
+                                    const int *effects, int num_effects,
+                                    Uint32 iterations);
+
 /*
  * Stops the effect on the haptic device.
  *
@@ -1274,6 +1274,24 @@ SDL_SYS_HapticRunEffect(SDL_Haptic * haptic, struct haptic_effect *effect,
 }
 
 
+/*
+ * Runs several effects.
+ */
+int
+SDL_SYS_HapticRunEffects(SDL_Haptic * haptic, const int *effects,
+                         int num_effects, Uint32 iterations)
+{
+    int i;
+
+    for (i = 0; i < num_effects; ++i) {
+        if (SDL_SYS_HapticRunEffect(haptic, &haptic->effects[effects[i]], iterations) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+
 /*
  * Stops an effect.
  */
@@ -127,6 +127,14 @@ SDL_SYS_HapticRunEffect(SDL_Haptic * haptic, struct haptic_effect *effect,
 }
 
 
+int
+SDL_SYS_HapticRunEffects(SDL_Haptic * haptic, const int *effects,
+                         int num_effects, Uint32 iterations)
+{
+    return SDL_SYS_LogicError();
+}
+
+
 int
 SDL_SYS_HapticStopEffect(SDL_Haptic * haptic, struct haptic_effect *effect)
 {
@@ -1000,6 +1000,11 @@ SDL_SYS_HapticUpdateEffect(SDL_Haptic * haptic,
     }
     linux_effect.id = effect->hweffect->effect.id;
 
+    /* Skip the upload if nothing changed, both were zeroed before filling */
+    if (SDL_memcmp(&linux_effect, &effect->hweffect->effect, sizeof(linux_effect)) == 0) {
+        return effect->hweffect->effect.id;
+    }
+
     /* See if it can be uploaded. */
     if (ioctl(haptic->hwdata->fd, EVIOCSFF, &linux_effect) < 0) {
         return SDL_SetError("Haptic: Error updating the effect: %s",
@@ -1037,6 +1042,36 @@ SDL_SYS_HapticRunEffect(SDL_Haptic * haptic, struct haptic_effect *effect,
 }
 
 
+/*
+ * Runs several effects with a single write, evdev accepts a batch of events.
+ */
+int
+SDL_SYS_HapticRunEffects(SDL_Haptic * haptic, const int *effects,
+                         int num_effects, Uint32 iterations)
+{
+    struct input_event run[16];
+    int i, n = 0;
+
+    for (i = 0; i < num_effects; ++i) {
+        SDL_zero(run[n]);
+        run[n].type = EV_FF;
+        run[n].code = haptic->effects[effects[i]].hweffect->effect.id;
+        /* We don't actually have infinity here, so we just do INT_MAX which is pretty damn close. */
+        run[n].value = (iterations > INT_MAX) ? INT_MAX : iterations;
+        ++n;
+
+        if (n == SDL_arraysize(run) || i == num_effects - 1) {
+            if (write(haptic->hwdata->fd, (const void *) run, n * sizeof(run[0])) < 0) {
+                return SDL_SetError("Haptic: Unable to run the effects: %s", strerror(errno));
+            }
+            n = 0;
+        }
+    }
+
+    return 0;
+}
+
+
 /*
  * Stops an effect.
  */
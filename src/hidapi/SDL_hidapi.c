@@ -34,6 +34,7 @@
 #include "SDL_thread.h"
 #include "SDL_timer.h"
 #include "SDL_hidapi_c.h"
+#include "../thread/SDL_systhread.h"
 
 #if !SDL_HIDAPI_DISABLED
 
@@ -80,6 +81,18 @@ static int inotify_fd = -1;
 
 #if defined(SDL_USE_LIBUDEV)
 static const SDL_UDEV_Symbols * usyms = NULL;
+
+/* A hidraw node added or removed since the last enumeration */
+typedef struct SDL_HIDAPI_RawDelta
+{
+    SDL_bool m_bAdded;
+    char *m_pszPath;
+    struct SDL_HIDAPI_RawDelta *m_pNext;
+} SDL_HIDAPI_RawDelta;
+
+/* Protects the hidraw deltas and the cached enumeration built from them,
+   since SDL_hid_enumerate() may be called from any thread */
+static SDL_mutex *SDL_HIDAPI_raw_lock = NULL;
 #endif
 
 static struct
@@ -106,6 +119,11 @@ static struct
     struct udev *m_pUdev;
     struct udev_monitor *m_pUdevMonitor;
     int m_nUdevFd;
+
+    /* hidraw changes not yet applied to the cached enumeration */
+    SDL_HIDAPI_RawDelta *m_pRawDeltas;
+    SDL_HIDAPI_RawDelta *m_pRawDeltasTail;
+    SDL_bool m_bRawDeltasLost;
 #endif
 } SDL_HIDAPI_discovery;
 
@@ -352,6 +370,62 @@ HIDAPI_InitializeDiscovery()
     }
 }
 
+#if defined(SDL_USE_LIBUDEV)
+static void
+HIDAPI_FreeRawDeltas(void)
+{
+    while (SDL_HIDAPI_discovery.m_pRawDeltas) {
+        SDL_HIDAPI_RawDelta *delta = SDL_HIDAPI_discovery.m_pRawDeltas;
+        SDL_HIDAPI_discovery.m_pRawDeltas = delta->m_pNext;
+        SDL_free(delta->m_pszPath);
+        SDL_free(delta);
+    }
+    SDL_HIDAPI_discovery.m_pRawDeltasTail = NULL;
+    SDL_HIDAPI_discovery.m_bRawDeltasLost = SDL_FALSE;
+}
+
+static void
+HIDAPI_AddRawDelta(struct udev_device *pUdevDevice, const char *action)
+{
+    const char *subsystem = usyms->udev_device_get_subsystem(pUdevDevice);
+    const char *devnode;
+    SDL_HIDAPI_RawDelta *delta;
+
+    if (!subsystem || SDL_strcmp(subsystem, "hidraw") != 0) {
+        return;
+    }
+
+    devnode = usyms->udev_device_get_devnode(pUdevDevice);
+    if (!action || !devnode) {
+        /* We don't know what changed, rescan everything */
+        SDL_HIDAPI_discovery.m_bRawDeltasLost = SDL_TRUE;
+        return;
+    }
+
+    delta = (SDL_HIDAPI_RawDelta *)SDL_malloc(sizeof(*delta));
+    if (delta) {
+        delta->m_pszPath = SDL_strdup(devnode);
+        if (!delta->m_pszPath) {
+            SDL_free(delta);
+            delta = NULL;
+        }
+    }
+    if (!delta) {
+        SDL_HIDAPI_discovery.m_bRawDeltasLost = SDL_TRUE;
+        return;
+    }
+    delta->m_bAdded = (SDL_strcmp(action, "add") == 0) ? SDL_TRUE : SDL_FALSE;
+    delta->m_pNext = NULL;
+
+    if (SDL_HIDAPI_discovery.m_pRawDeltasTail) {
+        SDL_HIDAPI_discovery.m_pRawDeltasTail->m_pNext = delta;
+    } else {
+        SDL_HIDAPI_discovery.m_pRawDeltas = delta;
+    }
+    SDL_HIDAPI_discovery.m_pRawDeltasTail = delta;
+}
+#endif /* SDL_USE_LIBUDEV */
+
 static void
 HIDAPI_UpdateDiscovery()
 {
@@ -417,6 +491,7 @@ HIDAPI_UpdateDiscovery()
                     action = usyms->udev_device_get_action(pUdevDevice);
                     if (!action || SDL_strcmp(action, "add") == 0 || SDL_strcmp(action, "remove") == 0) {
                         ++SDL_HIDAPI_discovery.m_unDeviceChangeCounter;
+                        HIDAPI_AddRawDelta(pUdevDevice, action);
                     }
                     usyms->udev_device_unref(pUdevDevice);
                 }
@@ -500,6 +575,7 @@ HIDAPI_ShutdownDiscovery()
             if (SDL_HIDAPI_discovery.m_pUdev) {
                 usyms->udev_unref(SDL_HIDAPI_discovery.m_pUdev);
             }
+            HIDAPI_FreeRawDeltas();
             SDL_UDEV_ReleaseUdevSyms();
             usyms = NULL;
         }
@@ -915,11 +991,39 @@ static const struct hidapi_backend LIBUSB_Backend = {
 };
 #endif /* SDL_LIBUSB_DYNAMIC */
 
+/* Input reports read ahead on a background thread, see SDL_hid_start_read_thread() */
+#define SDL_HID_QUEUED_REPORTS      64
+#define SDL_HID_QUEUED_REPORT_SIZE  256
+
+/* How often an idle read thread checks whether the device is being closed */
+#define SDL_HID_READ_THREAD_TIMEOUT 100
+
+typedef struct
+{
+    int length;
+    Uint8 data[SDL_HID_QUEUED_REPORT_SIZE];
+} SDL_hid_queued_report;
+
+typedef struct
+{
+    SDL_Thread *thread;
+    SDL_atomic_t running;
+    SDL_mutex *lock;
+    SDL_cond *cond;
+    SDL_bool error;
+    int head;
+    int count;
+    SDL_hid_queued_report reports[SDL_HID_QUEUED_REPORTS];
+} SDL_hid_read_queue;
+
 struct SDL_hid_device_
 {
     const void *magic;
     void *device;
     const struct hidapi_backend *backend;
+    SDL_bool nonblocking;
+    SDL_bool read_thread_attempted;
+    SDL_hid_read_queue *queue;
 };
 static char device_magic;
 
@@ -932,6 +1036,9 @@ CreateHIDDeviceWrapper(void *device, const struct hidapi_backend *backend)
     wrapper->magic = &device_magic;
     wrapper->device = device;
     wrapper->backend = backend;
+    wrapper->nonblocking = SDL_FALSE;
+    wrapper->read_thread_attempted = SDL_FALSE;
+    wrapper->queue = NULL;
     return wrapper;
 }
 
@@ -1100,10 +1207,18 @@ int SDL_hid_init(void)
         return -1;
     }
 
+#if defined(SDL_USE_LIBUDEV)
+    SDL_HIDAPI_raw_lock = SDL_CreateMutex();
+#endif
+
     ++SDL_hidapi_refcount;
     return 0;
 }
 
+#if HAVE_PLATFORM_BACKEND && defined(SDL_USE_LIBUDEV)
+static void HIDAPI_ClearRawCache(void);
+#endif
+
 int SDL_hid_exit(void)
 {
     int result = 0;
@@ -1117,10 +1232,19 @@ int SDL_hid_exit(void)
     }
     SDL_hidapi_refcount = 0;
 
+#if HAVE_PLATFORM_BACKEND && defined(SDL_USE_LIBUDEV)
+    HIDAPI_ClearRawCache();
+#endif
+
 #if !SDL_HIDAPI_DISABLED
     HIDAPI_ShutdownDiscovery();
 #endif
 
+#if defined(SDL_USE_LIBUDEV)
+    SDL_DestroyMutex(SDL_HIDAPI_raw_lock);
+    SDL_HIDAPI_raw_lock = NULL;
+#endif
+
 #if HAVE_PLATFORM_BACKEND
     if (udev_ctx) {
         result |= PLATFORM_hid_exit();
@@ -1150,7 +1274,13 @@ Uint32 SDL_hid_device_change_count(void)
         return 0;
     }
 
+#if defined(SDL_USE_LIBUDEV)
+    SDL_LockMutex(SDL_HIDAPI_raw_lock);
+#endif
     HIDAPI_UpdateDiscovery();
+#if defined(SDL_USE_LIBUDEV)
+    SDL_UnlockMutex(SDL_HIDAPI_raw_lock);
+#endif
 
     if (SDL_HIDAPI_discovery.m_unDeviceChangeCounter == 0) {
         /* Counter wrapped! */
@@ -1163,6 +1293,208 @@ Uint32 SDL_hid_device_change_count(void)
     return counter;
 }
 
+#if HAVE_PLATFORM_BACKEND && defined(SDL_USE_LIBUDEV)
+/* The hidraw enumeration is kept between calls and updated from the udev
+   add and remove notifications, so a device change costs a sysfs walk for
+   each changed node instead of one for every device on the system. */
+#define SDL_HIDAPI_RAW_CACHE_BUCKETS 64
+
+typedef struct SDL_HIDAPI_RawDevice
+{
+    struct SDL_hid_device_info *info;
+    Uint32 hash;
+    struct SDL_HIDAPI_RawDevice *prev;
+    struct SDL_HIDAPI_RawDevice *next;
+    struct SDL_HIDAPI_RawDevice *next_in_bucket;
+} SDL_HIDAPI_RawDevice;
+
+static struct
+{
+    SDL_bool m_bValid;
+    SDL_HIDAPI_RawDevice *m_pHead;
+    SDL_HIDAPI_RawDevice *m_pTail;
+    SDL_HIDAPI_RawDevice *m_pBuckets[SDL_HIDAPI_RAW_CACHE_BUCKETS];
+} SDL_HIDAPI_raw_cache;
+
+static Uint32
+HIDAPI_HashRawPath(const char *path)
+{
+    Uint32 hash = 5381;
+
+    while (*path) {
+        hash = hash * 33 + (Uint8)*path++;
+    }
+    return hash;
+}
+
+static SDL_HIDAPI_RawDevice *
+HIDAPI_FindRawDevice(const char *path, Uint32 hash)
+{
+    SDL_HIDAPI_RawDevice *entry = SDL_HIDAPI_raw_cache.m_pBuckets[hash % SDL_HIDAPI_RAW_CACHE_BUCKETS];
+
+    while (entry) {
+        if (entry->hash == hash && SDL_strcmp(entry->info->path, path) == 0) {
+            break;
+        }
+        entry = entry->next_in_bucket;
+    }
+    return entry;
+}
+
+static void
+HIDAPI_RemoveRawDevice(SDL_HIDAPI_RawDevice *entry)
+{
+    SDL_HIDAPI_RawDevice **link = &SDL_HIDAPI_raw_cache.m_pBuckets[entry->hash % SDL_HIDAPI_RAW_CACHE_BUCKETS];
+
+    while (*link != entry) {
+        link = &(*link)->next_in_bucket;
+    }
+    *link = entry->next_in_bucket;
+
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        SDL_HIDAPI_raw_cache.m_pHead = entry->next;
+    }
+    if (entry->next) {
+        entry->next->prev = entry->prev;
+    } else {
+        SDL_HIDAPI_raw_cache.m_pTail = entry->prev;
+    }
+
+    entry->info->next = NULL;
+    PLATFORM_hid_free_enumeration(entry->info);
+    SDL_free(entry);
+}
+
+/* Takes ownership of info, which must not be linked to other devices */
+static void
+HIDAPI_AddRawDevice(struct SDL_hid_device_info *info)
+{
+    SDL_HIDAPI_RawDevice *entry;
+    Uint32 hash;
+
+    if (!info->path) {
+        PLATFORM_hid_free_enumeration(info);
+        return;
+    }
+
+    hash = HIDAPI_HashRawPath(info->path);
+    entry = HIDAPI_FindRawDevice(info->path, hash);
+    if (entry) {
+        /* We saw this node before, replace it with the new information */
+        HIDAPI_RemoveRawDevice(entry);
+    }
+
+    entry = (SDL_HIDAPI_RawDevice *)SDL_malloc(sizeof(*entry));
+    if (!entry) {
+        PLATFORM_hid_free_enumeration(info);
+        /* We lost a device, rescan the next time around */
+        SDL_HIDAPI_raw_cache.m_bValid = SDL_FALSE;
+        return;
+    }
+    entry->info = info;
+    entry->hash = hash;
+    entry->prev = SDL_HIDAPI_raw_cache.m_pTail;
+    entry->next = NULL;
+    entry->next_in_bucket = SDL_HIDAPI_raw_cache.m_pBuckets[hash % SDL_HIDAPI_RAW_CACHE_BUCKETS];
+    SDL_HIDAPI_raw_cache.m_pBuckets[hash % SDL_HIDAPI_RAW_CACHE_BUCKETS] = entry;
+
+    if (SDL_HIDAPI_raw_cache.m_pTail) {
+        SDL_HIDAPI_raw_cache.m_pTail->next = entry;
+    } else {
+        SDL_HIDAPI_raw_cache.m_pHead = entry;
+    }
+    SDL_HIDAPI_raw_cache.m_pTail = entry;
+}
+
+static void
+HIDAPI_ClearRawCache(void)
+{
+    while (SDL_HIDAPI_raw_cache.m_pHead) {
+        HIDAPI_RemoveRawDevice(SDL_HIDAPI_raw_cache.m_pHead);
+    }
+    SDL_HIDAPI_raw_cache.m_bValid = SDL_FALSE;
+}
+
+/* Bring the cached hidraw enumeration up to date, with the raw lock held.
+   Returns SDL_FALSE if udev notifications aren't available to keep it current. */
+static SDL_bool
+HIDAPI_UpdateRawCache(void)
+{
+    SDL_HIDAPI_RawDelta *delta;
+
+    if (linux_enumeration_method != ENUMERATION_LIBUDEV || !SDL_HIDAPI_raw_lock) {
+        return SDL_FALSE;
+    }
+
+    HIDAPI_UpdateDiscovery();
+
+    if (!SDL_HIDAPI_discovery.m_bCanGetNotifications || SDL_HIDAPI_discovery.m_nUdevFd < 0) {
+        HIDAPI_ClearRawCache();
+        return SDL_FALSE;
+    }
+
+    if (!SDL_HIDAPI_raw_cache.m_bValid || SDL_HIDAPI_discovery.m_bRawDeltasLost) {
+        struct SDL_hid_device_info *devs, *next;
+
+        HIDAPI_ClearRawCache();
+        HIDAPI_FreeRawDeltas();
+
+        SDL_HIDAPI_raw_cache.m_bValid = SDL_TRUE;
+        for (devs = PLATFORM_hid_enumerate(0, 0); devs; devs = next) {
+            next = devs->next;
+            devs->next = NULL;
+            HIDAPI_AddRawDevice(devs);
+        }
+        return SDL_TRUE;
+    }
+
+    for (delta = SDL_HIDAPI_discovery.m_pRawDeltas; delta; delta = delta->m_pNext) {
+        if (delta->m_bAdded) {
+            struct SDL_hid_device_info *info = create_device_info_for_devnode(delta->m_pszPath);
+            if (info) {
+                HIDAPI_AddRawDevice(info);
+            }
+        } else {
+            SDL_HIDAPI_RawDevice *entry = HIDAPI_FindRawDevice(delta->m_pszPath, HIDAPI_HashRawPath(delta->m_pszPath));
+            if (entry) {
+                HIDAPI_RemoveRawDevice(entry);
+            }
+        }
+    }
+    HIDAPI_FreeRawDeltas();
+
+    return SDL_TRUE;
+}
+
+/* Link the matching cached devices into a list owned by the cache */
+static struct SDL_hid_device_info *
+HIDAPI_GetRawCacheList(unsigned short vendor_id, unsigned short product_id)
+{
+    struct SDL_hid_device_info *devs = NULL, *last = NULL;
+    SDL_HIDAPI_RawDevice *entry;
+
+    for (entry = SDL_HIDAPI_raw_cache.m_pHead; entry; entry = entry->next) {
+        struct SDL_hid_device_info *info = entry->info;
+
+        if ((vendor_id != 0x0 && vendor_id != info->vendor_id) ||
+            (product_id != 0x0 && product_id != info->product_id)) {
+            continue;
+        }
+
+        info->next = NULL;
+        if (last) {
+            last->next = info;
+        } else {
+            devs = info;
+        }
+        last = info;
+    }
+    return devs;
+}
+#endif /* HAVE_PLATFORM_BACKEND && SDL_USE_LIBUDEV */
+
 struct SDL_hid_device_info *SDL_hid_enumerate(unsigned short vendor_id, unsigned short product_id)
 {
 #if HAVE_PLATFORM_BACKEND || HAVE_DRIVER_BACKEND || defined(SDL_LIBUSB_DYNAMIC)
@@ -1177,6 +1509,7 @@ struct SDL_hid_device_info *SDL_hid_enumerate(unsigned short vendor_id, unsigned
 #if HAVE_PLATFORM_BACKEND
     struct SDL_hid_device_info *raw_devs = NULL;
     struct SDL_hid_device_info *raw_dev;
+    SDL_bool raw_devs_cached = SDL_FALSE;
 #endif
     struct SDL_hid_device_info *devs = NULL, *last = NULL, *new_dev;
 
@@ -1232,6 +1565,14 @@ struct SDL_hid_device_info *SDL_hid_enumerate(unsigned short vendor_id, unsigned
 
 #if HAVE_PLATFORM_BACKEND
     if (udev_ctx) {
+#if defined(SDL_USE_LIBUDEV)
+        /* The cached list is only valid while we hold the lock */
+        SDL_LockMutex(SDL_HIDAPI_raw_lock);
+        if (HIDAPI_UpdateRawCache()) {
+            raw_devs = HIDAPI_GetRawCacheList(vendor_id, product_id);
+            raw_devs_cached = SDL_TRUE;
+        } else
+#endif
         raw_devs = PLATFORM_hid_enumerate(vendor_id, product_id);
 #ifdef DEBUG_HIDAPI
         SDL_Log("hidraw devices found:");
@@ -1271,7 +1612,12 @@ struct SDL_hid_device_info *SDL_hid_enumerate(unsigned short vendor_id, unsigned
                         LIBUSB_hid_free_enumeration(usb_devs);
                     }
 #endif
-                    PLATFORM_hid_free_enumeration(raw_devs);
+                    if (!raw_devs_cached) {
+                        PLATFORM_hid_free_enumeration(raw_devs);
+                    }
+#if defined(SDL_USE_LIBUDEV)
+                    SDL_UnlockMutex(SDL_HIDAPI_raw_lock);
+#endif
                     SDL_hid_free_enumeration(devs);
                     SDL_OutOfMemory();
                     return NULL;
@@ -1287,7 +1633,12 @@ struct SDL_hid_device_info *SDL_hid_enumerate(unsigned short vendor_id, unsigned
                 last = new_dev;
             }
         }
-        PLATFORM_hid_free_enumeration(raw_devs);
+        if (!raw_devs_cached) {
+            PLATFORM_hid_free_enumeration(raw_devs);
+        }
+#if defined(SDL_USE_LIBUDEV)
+        SDL_UnlockMutex(SDL_HIDAPI_raw_lock);
+#endif
     }
 #endif /* HAVE_PLATFORM_BACKEND */
 
@@ -1384,6 +1735,149 @@ SDL_hid_device *SDL_hid_open_path(const char *path, int bExclusive /* = false */
     return NULL;
 }
 
+static int SDLCALL
+SDL_hid_read_thread(void *data)
+{
+    SDL_hid_device *device = (SDL_hid_device *)data;
+    SDL_hid_read_queue *queue = device->queue;
+    Uint8 report[SDL_HID_QUEUED_REPORT_SIZE];
+    int size;
+
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+    while (SDL_AtomicGet(&queue->running)) {
+        size = device->backend->hid_read_timeout(device->device, report, sizeof(report), SDL_HID_READ_THREAD_TIMEOUT);
+        if (size == 0) {
+            continue;
+        }
+
+        SDL_LockMutex(queue->lock);
+        if (size > 0) {
+            SDL_hid_queued_report *entry;
+
+            if (queue->count == SDL_HID_QUEUED_REPORTS) {
+                /* Nobody is reading the device, drop the oldest report */
+                queue->head = (queue->head + 1) % SDL_HID_QUEUED_REPORTS;
+                --queue->count;
+            }
+            entry = &queue->reports[(queue->head + queue->count) % SDL_HID_QUEUED_REPORTS];
+            SDL_memcpy(entry->data, report, size);
+            entry->length = size;
+            ++queue->count;
+        } else {
+            /* The device is gone, report the error once the queue is drained */
+            queue->error = SDL_TRUE;
+        }
+        SDL_CondSignal(queue->cond);
+        SDL_UnlockMutex(queue->lock);
+
+        if (size < 0) {
+            break;
+        }
+    }
+    return 0;
+}
+
+static void
+SDL_hid_free_read_queue(SDL_hid_read_queue *queue)
+{
+    if (queue->cond) {
+        SDL_DestroyCond(queue->cond);
+    }
+    if (queue->lock) {
+        SDL_DestroyMutex(queue->lock);
+    }
+    SDL_free(queue);
+}
+
+static void
+SDL_hid_stop_read_thread(SDL_hid_device *device)
+{
+    SDL_hid_read_queue *queue = device->queue;
+
+    if (queue) {
+        SDL_AtomicSet(&queue->running, 0);
+        SDL_WaitThread(queue->thread, NULL);
+        device->queue = NULL;
+        SDL_hid_free_read_queue(queue);
+    }
+}
+
+static int
+SDL_hid_read_queued(SDL_hid_device *device, unsigned char *data, size_t length, int milliseconds)
+{
+    SDL_hid_read_queue *queue = device->queue;
+    int result = 0;
+
+    SDL_LockMutex(queue->lock);
+    if (milliseconds < 0) {
+        while (queue->count == 0 && !queue->error) {
+            SDL_CondWait(queue->cond, queue->lock);
+        }
+    } else if (milliseconds > 0) {
+        const Uint32 timeout = SDL_GetTicks() + milliseconds;
+
+        while (queue->count == 0 && !queue->error) {
+            const Sint32 remaining = (Sint32)(timeout - SDL_GetTicks());
+            if (remaining <= 0) {
+                break;
+            }
+            SDL_CondWaitTimeout(queue->cond, queue->lock, remaining);
+        }
+    }
+
+    if (queue->count > 0) {
+        const SDL_hid_queued_report *entry = &queue->reports[queue->head];
+
+        result = SDL_min((int)length, entry->length);
+        SDL_memcpy(data, entry->data, result);
+        queue->head = (queue->head + 1) % SDL_HID_QUEUED_REPORTS;
+        --queue->count;
+    } else if (queue->error) {
+        result = -1;
+    }
+    SDL_UnlockMutex(queue->lock);
+
+    return result;
+}
+
+int SDL_hid_start_read_thread(SDL_hid_device *device)
+{
+    SDL_hid_read_queue *queue;
+
+    CHECK_DEVICE_MAGIC(device, -1);
+
+    if (device->queue) {
+        return 0;
+    }
+    if (device->read_thread_attempted) {
+        return -1;
+    }
+    device->read_thread_attempted = SDL_TRUE;
+
+    queue = (SDL_hid_read_queue *)SDL_calloc(1, sizeof(*queue));
+    if (!queue) {
+        return SDL_OutOfMemory();
+    }
+    queue->lock = SDL_CreateMutex();
+    queue->cond = SDL_CreateCond();
+    if (!queue->lock || !queue->cond) {
+        SDL_hid_free_read_queue(queue);
+        return -1;
+    }
+    SDL_AtomicSet(&queue->running, 1);
+
+    device->queue = queue;
+    queue->thread = SDL_CreateThreadInternal(SDL_hid_read_thread, "SDLHIDAPIRead", 16 * 1024, device);
+    if (!queue->thread) {
+        /* Keep reading the device directly */
+        device->queue = NULL;
+        SDL_hid_free_read_queue(queue);
+        return -1;
+    }
+    return 0;
+}
+
 int SDL_hid_write(SDL_hid_device *device, const unsigned char *data, size_t length)
 {
     int result;
@@ -1403,7 +1897,11 @@ int SDL_hid_read_timeout(SDL_hid_device *device, unsigned char *data, size_t len
 
     CHECK_DEVICE_MAGIC(device, -1);
 
-    result = device->backend->hid_read_timeout(device->device, data, length, milliseconds);
+    if (device->queue) {
+        result = SDL_hid_read_queued(device, data, length, milliseconds);
+    } else {
+        result = device->backend->hid_read_timeout(device->device, data, length, milliseconds);
+    }
     if (result < 0) {
         SDL_SetHIDAPIError(device->backend->hid_error(device->device));
     }
@@ -1416,7 +1914,11 @@ int SDL_hid_read(SDL_hid_device *device, unsigned char *data, size_t length)
 
     CHECK_DEVICE_MAGIC(device, -1);
 
-    result = device->backend->hid_read(device->device, data, length);
+    if (device->queue) {
+        result = SDL_hid_read_queued(device, data, length, device->nonblocking ? 0 : -1);
+    } else {
+        result = device->backend->hid_read(device->device, data, length);
+    }
     if (result < 0) {
         SDL_SetHIDAPIError(device->backend->hid_error(device->device));
     }
@@ -1432,6 +1934,8 @@ int SDL_hid_set_nonblocking(SDL_hid_device *device, int nonblock)
     result = device->backend->hid_set_nonblocking(device->device, nonblock);
     if (result < 0) {
         SDL_SetHIDAPIError(device->backend->hid_error(device->device));
+    } else {
+        device->nonblocking = nonblock ? SDL_TRUE : SDL_FALSE;
     }
     return result;
 }
@@ -1466,6 +1970,7 @@ void SDL_hid_close(SDL_hid_device *device)
 {
     CHECK_DEVICE_MAGIC(device,);
 
+    SDL_hid_stop_read_thread(device);
     device->backend->hid_close(device->device);
     DeleteHIDDeviceWrapper(device);
 }
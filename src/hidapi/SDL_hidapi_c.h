@@ -20,6 +20,12 @@
 */
 #include "../SDL_internal.h"
 
+#include "SDL_hidapi.h"
+
+/* Read input reports on a background thread and queue them for SDL_hid_read(),
+   returns 0 if the reports are queued, or -1 if the device is read directly */
+extern int SDL_hid_start_read_thread(SDL_hid_device *device);
+
 #ifdef SDL_JOYSTICK_HIDAPI
 
 #ifdef SDL_LIBUSB_DYNAMIC
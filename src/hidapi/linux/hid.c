@@ -463,6 +463,178 @@ int HID_API_EXPORT hid_exit(void)
 }
 
 
+static struct hid_device_info *create_device_info_for_device(struct udev_device *raw_dev, unsigned short vendor_id, unsigned short product_id)
+{
+	const char *dev_path;
+	const char *str;
+	struct udev_device *hid_dev; /* The device's HID udev node. */
+	struct udev_device *usb_dev; /* The device's USB udev node. */
+	struct udev_device *intf_dev; /* The device's interface (in the USB sense). */
+	unsigned short dev_vid;
+	unsigned short dev_pid;
+	char *serial_number_utf8 = NULL;
+	char *product_name_utf8 = NULL;
+	unsigned bus_type;
+	int result;
+	struct hid_device_info *cur_dev = NULL;
+
+	dev_path = udev_device_get_devnode(raw_dev);
+
+	hid_dev = udev_device_get_parent_with_subsystem_devtype(
+		raw_dev,
+		"hid",
+		NULL);
+
+	if (!hid_dev) {
+		/* Unable to find parent hid device. */
+		goto end;
+	}
+
+	result = parse_uevent_info(
+		udev_device_get_sysattr_value(hid_dev, "uevent"),
+		&bus_type,
+		&dev_vid,
+		&dev_pid,
+		&serial_number_utf8,
+		&product_name_utf8);
+
+	if (!result) {
+		/* parse_uevent_info() failed for at least one field. */
+		goto end;
+	}
+
+	if (bus_type != BUS_USB && bus_type != BUS_BLUETOOTH) {
+		/* We only know how to handle USB and BT devices. */
+		goto end;
+	}
+
+	if (access(dev_path, R_OK|W_OK) != 0) {
+		/* We can't open this device, ignore it */
+		goto end;
+	}
+
+	/* Check the VID/PID against the arguments */
+	if ((vendor_id == 0x0 || vendor_id == dev_vid) &&
+	    (product_id == 0x0 || product_id == dev_pid)) {
+
+		/* VID/PID match. Create the record. */
+		cur_dev = (struct hid_device_info *)calloc(1, sizeof(struct hid_device_info));
+		if (!cur_dev) {
+			goto end;
+		}
+
+		/* Fill out the record */
+		cur_dev->next = NULL;
+		cur_dev->path = dev_path? strdup(dev_path): NULL;
+
+		/* VID/PID */
+		cur_dev->vendor_id = dev_vid;
+		cur_dev->product_id = dev_pid;
+
+		/* Serial Number */
+		cur_dev->serial_number = utf8_to_wchar_t(serial_number_utf8);
+
+		/* Release Number */
+		cur_dev->release_number = 0x0;
+
+		/* Interface Number */
+		cur_dev->interface_number = -1;
+
+		switch (bus_type) {
+			case BUS_USB:
+				/* The device pointed to by raw_dev contains information about
+				   the hidraw device. In order to get information about the
+				   USB device, get the parent device with the
+				   subsystem/devtype pair of "usb"/"usb_device". This will
+				   be several levels up the tree, but the function will find
+				   it. */
+				usb_dev = udev_device_get_parent_with_subsystem_devtype(
+						raw_dev,
+						"usb",
+						"usb_device");
+
+				if (!usb_dev) {
+					/* Free this device */
+					free(cur_dev->serial_number);
+					free(cur_dev->path);
+					free(cur_dev);
+					cur_dev = NULL;
+					goto end;
+				}
+
+				/* Manufacturer and Product strings */
+				cur_dev->manufacturer_string = copy_udev_string(usb_dev, device_string_names[DEVICE_STRING_MANUFACTURER]);
+				cur_dev->product_string = copy_udev_string(usb_dev, device_string_names[DEVICE_STRING_PRODUCT]);
+
+				/* Release Number */
+				str = udev_device_get_sysattr_value(usb_dev, "bcdDevice");
+				cur_dev->release_number = (str)? strtol(str, NULL, 16): 0x0;
+
+				/* Get a handle to the interface's udev node. */
+				intf_dev = udev_device_get_parent_with_subsystem_devtype(
+						raw_dev,
+						"usb",
+						"usb_interface");
+				if (intf_dev) {
+					str = udev_device_get_sysattr_value(intf_dev, "bInterfaceNumber");
+					cur_dev->interface_number = (str)? strtol(str, NULL, 16): -1;
+				}
+
+				break;
+
+			case BUS_BLUETOOTH:
+				/* Manufacturer and Product strings */
+				cur_dev->manufacturer_string = wcsdup(L"");
+				cur_dev->product_string = utf8_to_wchar_t(product_name_utf8);
+
+				break;
+
+			default:
+				/* Unknown device type - this should never happen, as we
+				 * check for USB and Bluetooth devices above */
+				break;
+		}
+	}
+
+end:
+	free(serial_number_utf8);
+	free(product_name_utf8);
+	/* hid_dev, usb_dev and intf_dev don't need to be (and can't be)
+	   unref()d.  It will cause a double-free() error.  I'm not
+	   sure why.  */
+
+	return cur_dev;
+}
+
+/* Create the device record for a single hidraw node, as hid_enumerate()
+   would, without walking the rest of the hidraw devices. SDL_hidapi.c uses
+   this to apply udev add notifications to its cached enumeration. */
+static struct hid_device_info *create_device_info_for_devnode(const char *dev_path)
+{
+	struct udev *udev;
+	struct udev_device *raw_dev;
+	struct hid_device_info *info = NULL;
+	struct stat s;
+
+	if (stat(dev_path, &s) < 0 || !S_ISCHR(s.st_mode)) {
+		return NULL;
+	}
+
+	udev = udev_new();
+	if (!udev) {
+		return NULL;
+	}
+
+	raw_dev = udev_device_new_from_devnum(udev, 'c', s.st_rdev);
+	if (raw_dev) {
+		info = create_device_info_for_device(raw_dev, 0, 0);
+		udev_device_unref(raw_dev);
+	}
+	udev_unref(udev);
+
+	return info;
+}
+
 struct hid_device_info  HID_API_EXPORT *hid_enumerate(unsigned short vendor_id, unsigned short product_id)
 {
 	struct udev *udev;
@@ -471,7 +643,6 @@ struct hid_device_info  HID_API_EXPORT *hid_enumerate(unsigned short vendor_id,
 
 	struct hid_device_info *root = NULL; /* return object */
 	struct hid_device_info *cur_dev = NULL;
-	struct hid_device_info *prev_dev = NULL; /* previous device */
 
 	hid_init();
 
@@ -491,163 +662,29 @@ struct hid_device_info  HID_API_EXPORT *hid_enumerate(unsigned short vendor_id,
 	   create a udev_device record for it */
 	udev_list_entry_foreach(dev_list_entry, devices) {
 		const char *sysfs_path;
-		const char *dev_path;
-		const char *str;
 		struct udev_device *raw_dev; /* The device's hidraw udev node. */
-		struct udev_device *hid_dev; /* The device's HID udev node. */
-		struct udev_device *usb_dev; /* The device's USB udev node. */
-		struct udev_device *intf_dev; /* The device's interface (in the USB sense). */
-		unsigned short dev_vid;
-		unsigned short dev_pid;
-		char *serial_number_utf8 = NULL;
-		char *product_name_utf8 = NULL;
-		unsigned bus_type;
-		int result;
+		struct hid_device_info *tmp;
 
 		/* Get the filename of the /sys entry for the device
 		   and create a udev_device object (dev) representing it */
 		sysfs_path = udev_list_entry_get_name(dev_list_entry);
 		raw_dev = udev_device_new_from_syspath(udev, sysfs_path);
-		dev_path = udev_device_get_devnode(raw_dev);
-
-		hid_dev = udev_device_get_parent_with_subsystem_devtype(
-			raw_dev,
-			"hid",
-			NULL);
-
-		if (!hid_dev) {
-			/* Unable to find parent hid device. */
-			goto next;
-		}
-
-		result = parse_uevent_info(
-			udev_device_get_sysattr_value(hid_dev, "uevent"),
-			&bus_type,
-			&dev_vid,
-			&dev_pid,
-			&serial_number_utf8,
-			&product_name_utf8);
-
-		if (!result) {
-			/* parse_uevent_info() failed for at least one field. */
-			goto next;
-		}
-
-		if (bus_type != BUS_USB && bus_type != BUS_BLUETOOTH) {
-			/* We only know how to handle USB and BT devices. */
-			goto next;
-		}
-
-		if (access(dev_path, R_OK|W_OK) != 0) {
-			/* We can't open this device, ignore it */
-			goto next;
+		if (!raw_dev) {
+			continue;
 		}
 
-		/* Check the VID/PID against the arguments */
-		if ((vendor_id == 0x0 || vendor_id == dev_vid) &&
-		    (product_id == 0x0 || product_id == dev_pid)) {
-			struct hid_device_info *tmp;
-
-			/* VID/PID match. Create the record. */
-			tmp = (struct hid_device_info *)calloc(1, sizeof(struct hid_device_info));
+		tmp = create_device_info_for_device(raw_dev, vendor_id, product_id);
+		if (tmp) {
 			if (cur_dev) {
 				cur_dev->next = tmp;
 			}
 			else {
 				root = tmp;
 			}
-			prev_dev = cur_dev;
 			cur_dev = tmp;
-
-			/* Fill out the record */
-			cur_dev->next = NULL;
-			cur_dev->path = dev_path? strdup(dev_path): NULL;
-
-			/* VID/PID */
-			cur_dev->vendor_id = dev_vid;
-			cur_dev->product_id = dev_pid;
-
-			/* Serial Number */
-			cur_dev->serial_number = utf8_to_wchar_t(serial_number_utf8);
-
-			/* Release Number */
-			cur_dev->release_number = 0x0;
-
-			/* Interface Number */
-			cur_dev->interface_number = -1;
-
-			switch (bus_type) {
-				case BUS_USB:
-					/* The device pointed to by raw_dev contains information about
-					   the hidraw device. In order to get information about the
-					   USB device, get the parent device with the
-					   subsystem/devtype pair of "usb"/"usb_device". This will
-					   be several levels up the tree, but the function will find
-					   it. */
-					usb_dev = udev_device_get_parent_with_subsystem_devtype(
-							raw_dev,
-							"usb",
-							"usb_device");
-
-					if (!usb_dev) {
-						/* Free this device */
-						free(cur_dev->serial_number);
-						free(cur_dev->path);
-						free(cur_dev);
-
-						/* Take it off the device list. */
-						if (prev_dev) {
-							prev_dev->next = NULL;
-							cur_dev = prev_dev;
-						}
-						else {
-							cur_dev = root = NULL;
-						}
-
-						goto next;
-					}
-
-					/* Manufacturer and Product strings */
-					cur_dev->manufacturer_string = copy_udev_string(usb_dev, device_string_names[DEVICE_STRING_MANUFACTURER]);
-					cur_dev->product_string = copy_udev_string(usb_dev, device_string_names[DEVICE_STRING_PRODUCT]);
-
-					/* Release Number */
-					str = udev_device_get_sysattr_value(usb_dev, "bcdDevice");
-					cur_dev->release_number = (str)? strtol(str, NULL, 16): 0x0;
-
-					/* Get a handle to the interface's udev node. */
-					intf_dev = udev_device_get_parent_with_subsystem_devtype(
-							raw_dev,
-							"usb",
-							"usb_interface");
-					if (intf_dev) {
-						str = udev_device_get_sysattr_value(intf_dev, "bInterfaceNumber");
-						cur_dev->interface_number = (str)? strtol(str, NULL, 16): -1;
-					}
-
-					break;
-
-				case BUS_BLUETOOTH:
-					/* Manufacturer and Product strings */
-					cur_dev->manufacturer_string = wcsdup(L"");
-					cur_dev->product_string = utf8_to_wchar_t(product_name_utf8);
-
-					break;
-
-				default:
-					/* Unknown device type - this should never happen, as we
-					 * check for USB and Bluetooth devices above */
-					break;
-			}
 		}
 
-	next:
-		free(serial_number_utf8);
-		free(product_name_utf8);
 		udev_device_unref(raw_dev);
-		/* hid_dev, usb_dev and intf_dev don't need to be (and can't be)
-		   unref()d.  It will cause a double-free() error.  I'm not
-		   sure why.  */
 	}
 	/* Free the enumerator and udev objects. */
 	udev_enumerate_unref(enumerate);
@@ -83,6 +83,10 @@ typedef struct
 
     } output;
 
+    /* Next binding with the same input or output, -1 at the end of the chain */
+    int next_input;
+    int next_output;
+
 } SDL_ExtendedGameControllerBind;
 
 /* our hard coded list of mapping support */
@@ -98,15 +102,37 @@ typedef struct _ControllerMapping_t
     SDL_JoystickGUID guid;
     char *name;
     char *mapping;
+    SDL_bool name_allocated;    /* replaced strings are on the heap instead of in the mapping memory */
+    SDL_bool mapping_allocated;
     SDL_ControllerMappingPriority priority;
     struct _ControllerMapping_t *next;
+    struct _ControllerMapping_t *next_in_bucket;
 } ControllerMapping_t;
 
+/* Mappings are kept in a list in the order they were added, and also indexed by GUID */
+#define SDL_CONTROLLER_MAPPING_BUCKETS  256
+
 static SDL_JoystickGUID s_zeroGUID;
 static ControllerMapping_t *s_pSupportedControllers = NULL;
+static ControllerMapping_t *s_pSupportedControllersTail = NULL;
+static ControllerMapping_t *s_pMappingBuckets[SDL_CONTROLLER_MAPPING_BUCKETS];
 static ControllerMapping_t *s_pDefaultMapping = NULL;
 static ControllerMapping_t *s_pXInputMapping = NULL;
 
+/* Mapping entries and their strings live until SDL_GameControllerQuitMappings(),
+   so they are carved out of large blocks instead of being allocated one by one.
+   A replaced name or mapping string is simply abandoned until then. */
+#define SDL_CONTROLLER_MAPPING_BLOCK_SIZE   (32 * 1024)
+
+typedef struct _ControllerMappingBlock_t
+{
+    struct _ControllerMappingBlock_t *next;
+    size_t used;
+    size_t size;
+} ControllerMappingBlock_t;
+
+static ControllerMappingBlock_t *s_pMappingBlocks = NULL;
+
 /* The SDL game controller structure */
 struct _SDL_GameController
 {
@@ -118,6 +144,13 @@ struct _SDL_GameController
     SDL_ExtendedGameControllerBind *bindings;
     SDL_ExtendedGameControllerBind **last_match_axis;
     Uint8 *last_hat_mask;
+
+    /* First binding for each output and joystick input, -1 if there is none */
+    int axis_bindings[SDL_CONTROLLER_AXIS_MAX];
+    int button_bindings[SDL_CONTROLLER_BUTTON_MAX];
+    int *input_axis_bindings;
+    int *input_button_bindings;
+    int *input_hat_bindings;
     Uint32 guide_button_down;
 
     struct _SDL_GameController *next; /* pointer to next game controller we have allocated */
@@ -266,22 +299,19 @@ static void HandleJoystickAxis(SDL_GameController *gamecontroller, int axis, int
     SDL_ExtendedGameControllerBind *last_match = gamecontroller->last_match_axis[axis];
     SDL_ExtendedGameControllerBind *match = NULL;
 
-    for (i = 0; i < gamecontroller->num_bindings; ++i) {
+    for (i = gamecontroller->input_axis_bindings[axis]; i >= 0; i = gamecontroller->bindings[i].next_input) {
         SDL_ExtendedGameControllerBind *binding = &gamecontroller->bindings[i];
-        if (binding->inputType == SDL_CONTROLLER_BINDTYPE_AXIS &&
-            axis == binding->input.axis.axis) {
-            if (binding->input.axis.axis_min < binding->input.axis.axis_max) {
-                if (value >= binding->input.axis.axis_min &&
-                    value <= binding->input.axis.axis_max) {
-                    match = binding;
-                    break;
-                }
-            } else {
-                if (value >= binding->input.axis.axis_max &&
-                    value <= binding->input.axis.axis_min) {
-                    match = binding;
-                    break;
-                }
+        if (binding->input.axis.axis_min < binding->input.axis.axis_max) {
+            if (value >= binding->input.axis.axis_min &&
+                value <= binding->input.axis.axis_max) {
+                match = binding;
+                break;
+            }
+        } else {
+            if (value >= binding->input.axis.axis_max &&
+                value <= binding->input.axis.axis_min) {
+                match = binding;
+                break;
             }
         }
     }
@@ -314,19 +344,15 @@ static void HandleJoystickAxis(SDL_GameController *gamecontroller, int axis, int
 
 static void HandleJoystickButton(SDL_GameController *gamecontroller, int button, Uint8 state)
 {
-    int i;
+    int i = gamecontroller->input_button_bindings[button];
 
-    for (i = 0; i < gamecontroller->num_bindings; ++i) {
+    if (i >= 0) {
         SDL_ExtendedGameControllerBind *binding = &gamecontroller->bindings[i];
-        if (binding->inputType == SDL_CONTROLLER_BINDTYPE_BUTTON &&
-            button == binding->input.button) {
-            if (binding->outputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
-                int value = state ? binding->output.axis.axis_max : binding->output.axis.axis_min;
-                SDL_PrivateGameControllerAxis(gamecontroller, binding->output.axis.axis, (Sint16)value);
-            } else {
-                SDL_PrivateGameControllerButton(gamecontroller, binding->output.button, state);
-            }
-            break;
+        if (binding->outputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
+            int value = state ? binding->output.axis.axis_max : binding->output.axis.axis_min;
+            SDL_PrivateGameControllerAxis(gamecontroller, binding->output.axis.axis, (Sint16)value);
+        } else {
+            SDL_PrivateGameControllerButton(gamecontroller, binding->output.button, state);
         }
     }
 }
@@ -337,19 +363,17 @@ static void HandleJoystickHat(SDL_GameController *gamecontroller, int hat, Uint8
     Uint8 last_mask = gamecontroller->last_hat_mask[hat];
     Uint8 changed_mask = (last_mask ^ value);
 
-    for (i = 0; i < gamecontroller->num_bindings; ++i) {
+    for (i = gamecontroller->input_hat_bindings[hat]; i >= 0; i = gamecontroller->bindings[i].next_input) {
         SDL_ExtendedGameControllerBind *binding = &gamecontroller->bindings[i];
-        if (binding->inputType == SDL_CONTROLLER_BINDTYPE_HAT && hat == binding->input.hat.hat) {
-            if ((changed_mask & binding->input.hat.hat_mask) != 0) {
-                if (value & binding->input.hat.hat_mask) {
-                    if (binding->outputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
-                        SDL_PrivateGameControllerAxis(gamecontroller, binding->output.axis.axis, (Sint16)binding->output.axis.axis_max);
-                    } else {
-                        SDL_PrivateGameControllerButton(gamecontroller, binding->output.button, SDL_PRESSED);
-                    }
+        if ((changed_mask & binding->input.hat.hat_mask) != 0) {
+            if (value & binding->input.hat.hat_mask) {
+                if (binding->outputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
+                    SDL_PrivateGameControllerAxis(gamecontroller, binding->output.axis.axis, (Sint16)binding->output.axis.axis_max);
                 } else {
-                    ResetOutput(gamecontroller, binding);
+                    SDL_PrivateGameControllerButton(gamecontroller, binding->output.button, SDL_PRESSED);
                 }
+            } else {
+                ResetOutput(gamecontroller, binding);
             }
         }
     }
@@ -675,18 +699,34 @@ static ControllerMapping_t *SDL_CreateMappingForWGIController(SDL_JoystickGUID g
                       &existing, SDL_CONTROLLER_MAPPING_PRIORITY_DEFAULT);
 }
 
+/*
+ * Helper function to find the mapping index bucket for a GUID
+ */
+static ControllerMapping_t **SDL_PrivateGetControllerMappingBucket(SDL_JoystickGUID guid)
+{
+    /* FNV-1a, the GUID bytes that vary most (CRC, vendor, product) are spread across the GUID */
+    Uint32 hash = 2166136261u;
+    int i;
+
+    for (i = 0; i < (int)sizeof(guid.data); ++i) {
+        hash ^= guid.data[i];
+        hash *= 16777619u;
+    }
+    return &s_pMappingBuckets[(hash ^ (hash >> 16)) & (SDL_CONTROLLER_MAPPING_BUCKETS - 1)];
+}
+
 /*
  * Helper function to scan the mappings database for a controller with the specified GUID
  */
 static ControllerMapping_t *SDL_PrivateGetControllerMappingForGUID(SDL_JoystickGUID guid, SDL_bool exact_match)
 {
-    ControllerMapping_t *mapping = s_pSupportedControllers;
+    ControllerMapping_t *mapping = *SDL_PrivateGetControllerMappingBucket(guid);
 
     while (mapping) {
         if (SDL_memcmp(&guid, &mapping->guid, sizeof(guid)) == 0) {
             return mapping;
         }
-        mapping = mapping->next;
+        mapping = mapping->next_in_bucket;
     }
 
     if (!exact_match) {
@@ -956,6 +996,67 @@ SDL_PrivateGameControllerParseControllerConfigString(SDL_GameController *gamecon
     }
 }
 
+/*
+ * Link the bindings into per-input and per-output chains, keeping the mapping order
+ */
+static void SDL_PrivateBuildBindingTables(SDL_GameController *gamecontroller)
+{
+    SDL_Joystick *joystick = gamecontroller->joystick;
+    int i;
+
+    for (i = 0; i < SDL_CONTROLLER_AXIS_MAX; ++i) {
+        gamecontroller->axis_bindings[i] = -1;
+    }
+    for (i = 0; i < SDL_CONTROLLER_BUTTON_MAX; ++i) {
+        gamecontroller->button_bindings[i] = -1;
+    }
+    for (i = 0; i < (joystick->naxes + joystick->nbuttons + joystick->nhats); ++i) {
+        gamecontroller->input_axis_bindings[i] = -1;
+    }
+
+    for (i = gamecontroller->num_bindings; i--; ) {
+        SDL_ExtendedGameControllerBind *binding = &gamecontroller->bindings[i];
+        int *head = NULL;
+
+        if (binding->outputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
+            if (binding->output.axis.axis >= 0 && binding->output.axis.axis < SDL_CONTROLLER_AXIS_MAX) {
+                head = &gamecontroller->axis_bindings[binding->output.axis.axis];
+            }
+        } else {
+            if (binding->output.button >= 0 && binding->output.button < SDL_CONTROLLER_BUTTON_MAX) {
+                head = &gamecontroller->button_bindings[binding->output.button];
+            }
+        }
+        if (head) {
+            binding->next_output = *head;
+            *head = i;
+        } else {
+            binding->next_output = -1;
+        }
+
+        head = NULL;
+        if (binding->inputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
+            if (binding->input.axis.axis < joystick->naxes) {
+                head = &gamecontroller->input_axis_bindings[binding->input.axis.axis];
+            }
+        } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_BUTTON) {
+            if (binding->input.button < joystick->nbuttons) {
+                head = &gamecontroller->input_button_bindings[binding->input.button];
+            }
+        } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_HAT) {
+            if (binding->input.hat.hat < joystick->nhats) {
+                head = &gamecontroller->input_hat_bindings[binding->input.hat.hat];
+            }
+        }
+        if (head) {
+            binding->next_input = *head;
+            *head = i;
+        } else {
+            binding->next_input = -1;
+        }
+    }
+}
+
 /*
  * Make a new button mapping struct
  */
@@ -970,6 +1071,7 @@ static void SDL_PrivateLoadButtonMapping(SDL_GameController *gamecontroller, con
     }
 
     SDL_PrivateGameControllerParseControllerConfigString(gamecontroller, pchMapping);
+    SDL_PrivateBuildBindingTables(gamecontroller);
 
     /* Set the zero point for triggers */
     for (i = 0; i < gamecontroller->num_bindings; ++i) {
@@ -988,19 +1090,15 @@ static void SDL_PrivateLoadButtonMapping(SDL_GameController *gamecontroller, con
 
 
 /*
- * grab the guid string from a mapping string
+ * grab the guid string from a mapping string into a buffer
+ * Longer strings are truncated, only the first 32 hex digits are used for the GUID anyway
  */
-static char *SDL_PrivateGetControllerGUIDFromMappingString(const char *pMapping)
+static SDL_bool SDL_PrivateGetControllerGUIDFromMappingString(const char *pMapping, char *pchGUID, size_t size)
 {
     const char *pFirstComma = SDL_strchr(pMapping, ',');
     if (pFirstComma) {
-        char *pchGUID = SDL_malloc(pFirstComma - pMapping + 1);
-        if (!pchGUID) {
-            SDL_OutOfMemory();
-            return NULL;
-        }
-        SDL_memcpy(pchGUID, pMapping, pFirstComma - pMapping);
-        pchGUID[pFirstComma - pMapping] = '\0';
+        /* Anything longer than a GUID is truncated, it wouldn't parse anyway */
+        SDL_strlcpy(pchGUID, pMapping, SDL_min((size_t)(pFirstComma - pMapping + 1), size));
 
         /* Convert old style GUIDs to the new style in 2.0.5 */
 #if __WIN32__
@@ -1020,55 +1118,131 @@ static char *SDL_PrivateGetControllerGUIDFromMappingString(const char *pMapping)
             SDL_memcpy(&pchGUID[0], "03000000", 8);
         }
 #endif
-        return pchGUID;
+        return SDL_TRUE;
     }
-    return NULL;
+    return SDL_FALSE;
 }
 
 
 /*
- * grab the name string from a mapping string
+ * Allocate memory that lives until the mappings are released
  */
-static char *SDL_PrivateGetControllerNameFromMappingString(const char *pMapping)
+static void *SDL_PrivateAllocMappingMemory(size_t size)
 {
-    const char *pFirstComma, *pSecondComma;
-    char *pchName;
+    ControllerMappingBlock_t *block = s_pMappingBlocks;
+    void *result;
 
-    pFirstComma = SDL_strchr(pMapping, ',');
-    if (!pFirstComma)
-        return NULL;
+    /* Keep everything pointer aligned, the entries are stored alongside the strings */
+    size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
 
-    pSecondComma = SDL_strchr(pFirstComma + 1, ',');
-    if (!pSecondComma)
-        return NULL;
+    if (!block || (block->size - block->used) < size) {
+        size_t block_size = SDL_CONTROLLER_MAPPING_BLOCK_SIZE;
+        if (size > block_size / 4) {
+            block_size = size;
+        }
+        block = (ControllerMappingBlock_t *)SDL_malloc(sizeof(*block) + block_size);
+        if (!block) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        block->used = 0;
+        block->size = block_size;
+        if (s_pMappingBlocks && size == block_size) {
+            /* Oversized allocation, keep filling the current block */
+            block->next = s_pMappingBlocks->next;
+            s_pMappingBlocks->next = block;
+        } else {
+            block->next = s_pMappingBlocks;
+            s_pMappingBlocks = block;
+        }
+    }
 
-    pchName = SDL_malloc(pSecondComma - pFirstComma);
-    if (!pchName) {
+    result = (Uint8 *)(block + 1) + block->used;
+    block->used += size;
+    return result;
+}
+
+static char *SDL_PrivateCopyMappingString(const char *str, size_t length)
+{
+    char *copy = (char *)SDL_PrivateAllocMappingMemory(length + 1);
+    if (copy) {
+        SDL_memcpy(copy, str, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+/*
+ * Get memory for a replacement mapping string, reusing the current string if
+ * the new one fits. Otherwise it's allocated on the heap, and freed when it's
+ * replaced again, so updating a mapping repeatedly doesn't grow the mapping memory.
+ */
+static char *SDL_PrivateGetReplacementMappingString(char *current, size_t length)
+{
+    char *memory;
+
+    if (SDL_strlen(current) >= length) {
+        return current;
+    }
+    memory = (char *)SDL_malloc(length + 1);
+    if (!memory) {
         SDL_OutOfMemory();
-        return NULL;
     }
-    SDL_memcpy(pchName, pFirstComma + 1, pSecondComma - pFirstComma);
-    pchName[pSecondComma - pFirstComma - 1] = 0;
-    return pchName;
+    return memory;
+}
+
+static void SDL_PrivateReplaceMappingString(char **string, SDL_bool *allocated, char *memory, const char *str, size_t length)
+{
+    if (memory != *string) {
+        if (*allocated) {
+            SDL_free(*string);
+        }
+        *string = memory;
+        *allocated = SDL_TRUE;
+    }
+    SDL_memcpy(memory, str, length);
+    memory[length] = '\0';
 }
 
+static void SDL_PrivateFreeMappingMemory(void)
+{
+    ControllerMapping_t *pControllerMapping;
+
+    for (pControllerMapping = s_pSupportedControllers; pControllerMapping; pControllerMapping = pControllerMapping->next) {
+        if (pControllerMapping->name_allocated) {
+            SDL_free(pControllerMapping->name);
+        }
+        if (pControllerMapping->mapping_allocated) {
+            SDL_free(pControllerMapping->mapping);
+        }
+    }
+
+    while (s_pMappingBlocks) {
+        ControllerMappingBlock_t *block = s_pMappingBlocks;
+        s_pMappingBlocks = block->next;
+        SDL_free(block);
+    }
+}
 
 /*
- * grab the button mapping string from a mapping string
+ * split a mapping string into its name and button mapping parts, without copying
  */
-static char *SDL_PrivateGetControllerMappingFromMappingString(const char *pMapping)
+static SDL_bool SDL_PrivateSplitMappingString(const char *pMapping, const char **pchName, size_t *nameLength, const char **pchMapping)
 {
     const char *pFirstComma, *pSecondComma;
 
     pFirstComma = SDL_strchr(pMapping, ',');
     if (!pFirstComma)
-        return NULL;
+        return SDL_FALSE;
 
     pSecondComma = SDL_strchr(pFirstComma + 1, ',');
     if (!pSecondComma)
-        return NULL;
+        return SDL_FALSE;
 
-    return SDL_strdup(pSecondComma + 1); /* mapping is everything after the 3rd comma */
+    *pchName = pFirstComma + 1;
+    *nameLength = (pSecondComma - pFirstComma - 1);
+    *pchMapping = pSecondComma + 1; /* mapping is everything after the 3rd comma */
+    return SDL_TRUE;
 }
 
 /*
@@ -1100,19 +1274,15 @@ static void SDL_PrivateGameControllerRefreshMapping(ControllerMapping_t *pContro
 static ControllerMapping_t *
 SDL_PrivateAddMappingForGUID(SDL_JoystickGUID jGUID, const char *mappingString, SDL_bool *existing, SDL_ControllerMappingPriority priority)
 {
+    const char *pName;
+    const char *pMapping;
+    size_t nameLength;
     char *pchName;
     char *pchMapping;
     ControllerMapping_t *pControllerMapping;
+    ControllerMapping_t **bucket;
 
-    pchName = SDL_PrivateGetControllerNameFromMappingString(mappingString);
-    if (!pchName) {
-        SDL_SetError("Couldn't parse name from %s", mappingString);
-        return NULL;
-    }
-
-    pchMapping = SDL_PrivateGetControllerMappingFromMappingString(mappingString);
-    if (!pchMapping) {
-        SDL_free(pchName);
+    if (!SDL_PrivateSplitMappingString(mappingString, &pName, &nameLength, &pMapping)) {
         SDL_SetError("Couldn't parse %s", mappingString);
         return NULL;
     }
@@ -1121,46 +1291,56 @@ SDL_PrivateAddMappingForGUID(SDL_JoystickGUID jGUID, const char *mappingString,
     if (pControllerMapping) {
         /* Only overwrite the mapping if the priority is the same or higher. */
         if (pControllerMapping->priority <= priority) {
+            const size_t mappingLength = SDL_strlen(pMapping);
+
+            pchName = SDL_PrivateGetReplacementMappingString(pControllerMapping->name, nameLength);
+            pchMapping = SDL_PrivateGetReplacementMappingString(pControllerMapping->mapping, mappingLength);
+            if (!pchName || !pchMapping) {
+                if (pchName != pControllerMapping->name) {
+                    SDL_free(pchName);
+                }
+                if (pchMapping != pControllerMapping->mapping) {
+                    SDL_free(pchMapping);
+                }
+                return NULL;
+            }
+
             /* Update existing mapping */
-            SDL_free(pControllerMapping->name);
-            pControllerMapping->name = pchName;
-            SDL_free(pControllerMapping->mapping);
-            pControllerMapping->mapping = pchMapping;
+            SDL_PrivateReplaceMappingString(&pControllerMapping->name, &pControllerMapping->name_allocated, pchName, pName, nameLength);
+            SDL_PrivateReplaceMappingString(&pControllerMapping->mapping, &pControllerMapping->mapping_allocated, pchMapping, pMapping, mappingLength);
             pControllerMapping->priority = priority;
             /* refresh open controllers */
             SDL_PrivateGameControllerRefreshMapping(pControllerMapping);
-        } else {
-            SDL_free(pchName);
-            SDL_free(pchMapping);
         }
         *existing = SDL_TRUE;
     } else {
-        pControllerMapping = SDL_malloc(sizeof(*pControllerMapping));
-        if (!pControllerMapping) {
-            SDL_free(pchName);
-            SDL_free(pchMapping);
-            SDL_OutOfMemory();
+        pControllerMapping = (ControllerMapping_t *)SDL_PrivateAllocMappingMemory(sizeof(*pControllerMapping));
+        pchName = SDL_PrivateCopyMappingString(pName, nameLength);
+        pchMapping = SDL_PrivateCopyMappingString(pMapping, SDL_strlen(pMapping));
+        if (!pControllerMapping || !pchName || !pchMapping) {
             return NULL;
         }
+        bucket = SDL_PrivateGetControllerMappingBucket(jGUID);
+
         pControllerMapping->guid = jGUID;
         pControllerMapping->name = pchName;
         pControllerMapping->mapping = pchMapping;
+        pControllerMapping->name_allocated = SDL_FALSE;
+        pControllerMapping->mapping_allocated = SDL_FALSE;
         pControllerMapping->next = NULL;
         pControllerMapping->priority = priority;
 
-        if (s_pSupportedControllers) {
-            /* Add the mapping to the end of the list */
-            ControllerMapping_t *pCurrMapping, *pPrevMapping;
-
-            for ( pPrevMapping = s_pSupportedControllers, pCurrMapping = pPrevMapping->next;
-                  pCurrMapping; 
-                  pPrevMapping = pCurrMapping, pCurrMapping = pCurrMapping->next ) {
-                /* continue; */
-            }
-            pPrevMapping->next = pControllerMapping;
+        /* Add the mapping to the end of the list */
+        if (s_pSupportedControllersTail) {
+            s_pSupportedControllersTail->next = pControllerMapping;
         } else {
             s_pSupportedControllers = pControllerMapping;
         }
+        s_pSupportedControllersTail = pControllerMapping;
+
+        pControllerMapping->next_in_bucket = *bucket;
+        *bucket = pControllerMapping;
+
         *existing = SDL_FALSE;
     }
     return pControllerMapping;
@@ -1309,84 +1489,13 @@ static ControllerMapping_t *SDL_PrivateGetControllerMapping(int device_index)
     return mapping;
 }
 
-/*
- * Add or update an entry into the Mappings Database
- */
-int
-SDL_GameControllerAddMappingsFromRW(SDL_RWops * rw, int freerw)
-{
-    const char *platform = SDL_GetPlatform();
-    int controllers = 0;
-    char *buf, *line, *line_end, *tmp, *comma, line_platform[64];
-    size_t db_size, platform_len;
-    
-    if (rw == NULL) {
-        return SDL_SetError("Invalid RWops");
-    }
-    db_size = (size_t)SDL_RWsize(rw);
-    
-    buf = (char *)SDL_malloc(db_size + 1);
-    if (buf == NULL) {
-        if (freerw) {
-            SDL_RWclose(rw);
-        }
-        return SDL_SetError("Could not allocate space to read DB into memory");
-    }
-    
-    if (SDL_RWread(rw, buf, db_size, 1) != 1) {
-        if (freerw) {
-            SDL_RWclose(rw);
-        }
-        SDL_free(buf);
-        return SDL_SetError("Could not read DB");
-    }
-    
-    if (freerw) {
-        SDL_RWclose(rw);
-    }
-    
-    buf[db_size] = '\0';
-    line = buf;
-    
-    while (line < buf + db_size) {
-        line_end = SDL_strchr(line, '\n');
-        if (line_end != NULL) {
-            *line_end = '\0';
-        } else {
-            line_end = buf + db_size;
-        }
-        
-        /* Extract and verify the platform */
-        tmp = SDL_strstr(line, SDL_CONTROLLER_PLATFORM_FIELD);
-        if (tmp != NULL) {
-            tmp += SDL_strlen(SDL_CONTROLLER_PLATFORM_FIELD);
-            comma = SDL_strchr(tmp, ',');
-            if (comma != NULL) {
-                platform_len = comma - tmp + 1;
-                if (platform_len + 1 < SDL_arraysize(line_platform)) {
-                    SDL_strlcpy(line_platform, tmp, platform_len);
-                    if (SDL_strncasecmp(line_platform, platform, platform_len) == 0 &&
-                        SDL_GameControllerAddMapping(line) > 0) {
-                        controllers++;
-                    }
-                }
-            }
-        }
-
-        line = line_end + 1;
-    }
-
-    SDL_free(buf);
-    return controllers;
-}
-
 /*
  * Add or update an entry into the Mappings Database with a priority
  */
 static int
 SDL_PrivateGameControllerAddMapping(const char *mappingString, SDL_ControllerMappingPriority priority)
 {
-    char *pchGUID;
+    char pchGUID[33];
     SDL_JoystickGUID jGUID;
     SDL_bool is_default_mapping = SDL_FALSE;
     SDL_bool is_xinput_mapping = SDL_FALSE;
@@ -1459,8 +1568,7 @@ SDL_PrivateGameControllerAddMapping(const char *mappingString, SDL_ControllerMap
     }
 #endif
 
-    pchGUID = SDL_PrivateGetControllerGUIDFromMappingString(mappingString);
-    if (!pchGUID) {
+    if (!SDL_PrivateGetControllerGUIDFromMappingString(mappingString, pchGUID, sizeof(pchGUID))) {
         return SDL_SetError("Couldn't parse GUID from %s", mappingString);
     }
     if (!SDL_strcasecmp(pchGUID, "default")) {
@@ -1469,7 +1577,6 @@ SDL_PrivateGameControllerAddMapping(const char *mappingString, SDL_ControllerMap
         is_xinput_mapping = SDL_TRUE;
     }
     jGUID = SDL_JoystickGetGUIDFromString(pchGUID);
-    SDL_free(pchGUID);
 
     pControllerMapping = SDL_PrivateAddMappingForGUID(jGUID, mappingString, &existing, priority);
     if (!pControllerMapping) {
@@ -1488,6 +1595,84 @@ SDL_PrivateGameControllerAddMapping(const char *mappingString, SDL_ControllerMap
     }
 }
 
+/*
+ * Add or update an entry into the Mappings Database
+ */
+int
+SDL_GameControllerAddMappingsFromRW(SDL_RWops * rw, int freerw)
+{
+    const char *platform = SDL_GetPlatform();
+    int controllers = 0;
+    char *buf, *line, *line_end, *end, *tmp;
+    size_t db_size, platform_len, field_len;
+
+    if (rw == NULL) {
+        return SDL_SetError("Invalid RWops");
+    }
+    db_size = (size_t)SDL_RWsize(rw);
+
+    buf = (char *)SDL_malloc(db_size + 1);
+    if (buf == NULL) {
+        if (freerw) {
+            SDL_RWclose(rw);
+        }
+        return SDL_SetError("Could not allocate space to read DB into memory");
+    }
+
+    if (db_size > 0 && SDL_RWread(rw, buf, db_size, 1) != 1) {
+        if (freerw) {
+            SDL_RWclose(rw);
+        }
+        SDL_free(buf);
+        return SDL_SetError("Could not read DB");
+    }
+
+    if (freerw) {
+        SDL_RWclose(rw);
+    }
+
+    buf[db_size] = '\0';
+    end = buf + db_size;
+    platform_len = SDL_strlen(platform);
+    field_len = SDL_strlen(SDL_CONTROLLER_PLATFORM_FIELD);
+
+    /* The lines are terminated in place and handed straight to the mapping
+       parser, which copies only the entries that are actually kept. */
+    for (line = buf; line < end; line = line_end + 1) {
+        line_end = SDL_strchr(line, '\n');
+        if (line_end == NULL) {
+            line_end = end;
+        }
+        *line_end = '\0';
+
+        /* Skip blank lines and comments without looking any further */
+        if (*line == '#' || *line == '\r' || *line == '\0') {
+            continue;
+        }
+        if (line_end > line && line_end[-1] == '\r') {
+            line_end[-1] = '\0';
+        }
+
+        /* Verify the platform, most lines in a community database are for other platforms */
+        tmp = SDL_strstr(line, SDL_CONTROLLER_PLATFORM_FIELD);
+        if (tmp == NULL) {
+            continue;
+        }
+        tmp += field_len;
+        if (SDL_strncasecmp(tmp, platform, platform_len) != 0 ||
+            (tmp[platform_len] != ',' && tmp[platform_len] != '\0')) {
+            continue;
+        }
+
+        if (SDL_PrivateGameControllerAddMapping(line, SDL_CONTROLLER_MAPPING_PRIORITY_API) > 0) {
+            controllers++;
+        }
+    }
+
+    SDL_free(buf);
+    return controllers;
+}
+
 /*
  * Add or update an entry into the Mappings Database
  */
@@ -1945,6 +2130,22 @@ SDL_GameControllerOpen(int device_index)
         }
     }
 
+    /* One extra entry so there is always an allocation, even without any inputs */
+    gamecontroller->input_axis_bindings = (int *)SDL_malloc((gamecontroller->joystick->naxes +
+                                                             gamecontroller->joystick->nbuttons +
+                                                             gamecontroller->joystick->nhats + 1) * sizeof(int));
+    if (!gamecontroller->input_axis_bindings) {
+        SDL_OutOfMemory();
+        SDL_JoystickClose(gamecontroller->joystick);
+        SDL_free(gamecontroller->last_match_axis);
+        SDL_free(gamecontroller->last_hat_mask);
+        SDL_free(gamecontroller);
+        SDL_UnlockJoysticks();
+        return NULL;
+    }
+    gamecontroller->input_button_bindings = gamecontroller->input_axis_bindings + gamecontroller->joystick->naxes;
+    gamecontroller->input_hat_bindings = gamecontroller->input_button_bindings + gamecontroller->joystick->nbuttons;
+
     SDL_PrivateLoadButtonMapping(gamecontroller, pSupportedController->name, pSupportedController->mapping);
 
     /* Add the controller to list */
@@ -1979,64 +2180,83 @@ SDL_GameControllerHasAxis(SDL_GameController *gamecontroller, SDL_GameController
 }
 
 /*
- * Get the current state of an axis control on a controller
+ * Get the current state of an axis control on a controller, from any number of bindings
  */
-Sint16
-SDL_GameControllerGetAxis(SDL_GameController *gamecontroller, SDL_GameControllerAxis axis)
+static Sint16
+SDL_PrivateGameControllerGetAxisState(SDL_GameController *gamecontroller, SDL_GameControllerAxis axis)
 {
     int i;
 
-    if (!gamecontroller)
-        return 0;
-
-    for (i = 0; i < gamecontroller->num_bindings; ++i) {
+    for (i = gamecontroller->axis_bindings[axis]; i >= 0; i = gamecontroller->bindings[i].next_output) {
         SDL_ExtendedGameControllerBind *binding = &gamecontroller->bindings[i];
-        if (binding->outputType == SDL_CONTROLLER_BINDTYPE_AXIS && binding->output.axis.axis == axis) {
-            int value = 0;
-            SDL_bool valid_input_range;
-            SDL_bool valid_output_range;
+        int value = 0;
+        SDL_bool valid_input_range;
+        SDL_bool valid_output_range;
 
-            if (binding->inputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
-                value = SDL_JoystickGetAxis(gamecontroller->joystick, binding->input.axis.axis);
-                if (binding->input.axis.axis_min < binding->input.axis.axis_max) {
-                    valid_input_range = (value >= binding->input.axis.axis_min && value <= binding->input.axis.axis_max);
-                } else {
-                    valid_input_range = (value >= binding->input.axis.axis_max && value <= binding->input.axis.axis_min);
-                }
-                if (valid_input_range) {
-                    if (binding->input.axis.axis_min != binding->output.axis.axis_min || binding->input.axis.axis_max != binding->output.axis.axis_max) {
-                        float normalized_value = (float)(value - binding->input.axis.axis_min) / (binding->input.axis.axis_max - binding->input.axis.axis_min);
-                        value = binding->output.axis.axis_min + (int)(normalized_value * (binding->output.axis.axis_max - binding->output.axis.axis_min));
-                    }
-                } else {
-                    value = 0;
-                }
-            } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_BUTTON) {
-                value = SDL_JoystickGetButton(gamecontroller->joystick, binding->input.button);
-                if (value == SDL_PRESSED) {
-                    value = binding->output.axis.axis_max;
-                }
-            } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_HAT) {
-                int hat_mask = SDL_JoystickGetHat(gamecontroller->joystick, binding->input.hat.hat);
-                if (hat_mask & binding->input.hat.hat_mask) {
-                    value = binding->output.axis.axis_max;
-                }
+        if (binding->inputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
+            value = SDL_JoystickGetAxis(gamecontroller->joystick, binding->input.axis.axis);
+            if (binding->input.axis.axis_min < binding->input.axis.axis_max) {
+                valid_input_range = (value >= binding->input.axis.axis_min && value <= binding->input.axis.axis_max);
+            } else {
+                valid_input_range = (value >= binding->input.axis.axis_max && value <= binding->input.axis.axis_min);
             }
-
-            if (binding->output.axis.axis_min < binding->output.axis.axis_max) {
-                valid_output_range = (value >= binding->output.axis.axis_min && value <= binding->output.axis.axis_max);
+            if (valid_input_range) {
+                if (binding->input.axis.axis_min != binding->output.axis.axis_min || binding->input.axis.axis_max != binding->output.axis.axis_max) {
+                    float normalized_value = (float)(value - binding->input.axis.axis_min) / (binding->input.axis.axis_max - binding->input.axis.axis_min);
+                    value = binding->output.axis.axis_min + (int)(normalized_value * (binding->output.axis.axis_max - binding->output.axis.axis_min));
+                }
             } else {
-                valid_output_range = (value >= binding->output.axis.axis_max && value <= binding->output.axis.axis_min);
+                value = 0;
+            }
+        } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_BUTTON) {
+            value = SDL_JoystickGetButton(gamecontroller->joystick, binding->input.button);
+            if (value == SDL_PRESSED) {
+                value = binding->output.axis.axis_max;
             }
-            /* If the value is zero, there might be another binding that makes it non-zero */
-            if (value != 0 && valid_output_range) {
-                return (Sint16)value;
+        } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_HAT) {
+            int hat_mask = SDL_JoystickGetHat(gamecontroller->joystick, binding->input.hat.hat);
+            if (hat_mask & binding->input.hat.hat_mask) {
+                value = binding->output.axis.axis_max;
             }
         }
+
+        if (binding->output.axis.axis_min < binding->output.axis.axis_max) {
+            valid_output_range = (value >= binding->output.axis.axis_min && value <= binding->output.axis.axis_max);
+        } else {
+            valid_output_range = (value >= binding->output.axis.axis_max && value <= binding->output.axis.axis_min);
+        }
+        /* If the value is zero, there might be another binding that makes it non-zero */
+        if (value != 0 && valid_output_range) {
+            return (Sint16)value;
+        }
     }
     return 0;
 }
 
+/*
+ * Get the current state of an axis control on a controller
+ */
+Sint16
+SDL_GameControllerGetAxis(SDL_GameController *gamecontroller, SDL_GameControllerAxis axis)
+{
+    Sint16 value;
+    int sequence;
+
+    if (!gamecontroller)
+        return 0;
+
+    if (axis < 0 || axis >= SDL_CONTROLLER_AXIS_MAX)
+        return 0;
+
+    /* Several joystick inputs may feed this axis, read them as one snapshot */
+    do {
+        sequence = SDL_PrivateJoystickBeginStateRead(gamecontroller->joystick);
+        value = SDL_PrivateGameControllerGetAxisState(gamecontroller, axis);
+    } while (!SDL_PrivateJoystickEndStateRead(gamecontroller->joystick, sequence));
+
+    return value;
+}
+
 /**
  *  Return whether a game controller has a given button
  */
@@ -2048,46 +2268,64 @@ SDL_GameControllerHasButton(SDL_GameController *gamecontroller, SDL_GameControll
 }
 
 /*
- * Get the current state of a button on a controller
+ * Get the current state of a button on a controller, from any number of bindings
  */
-Uint8
-SDL_GameControllerGetButton(SDL_GameController *gamecontroller, SDL_GameControllerButton button)
+static Uint8
+SDL_PrivateGameControllerGetButtonState(SDL_GameController *gamecontroller, SDL_GameControllerButton button)
 {
     int i;
 
-    if (!gamecontroller)
-        return 0;
-
-    for (i = 0; i < gamecontroller->num_bindings; ++i) {
+    for (i = gamecontroller->button_bindings[button]; i >= 0; i = gamecontroller->bindings[i].next_output) {
         SDL_ExtendedGameControllerBind *binding = &gamecontroller->bindings[i];
-        if (binding->outputType == SDL_CONTROLLER_BINDTYPE_BUTTON && binding->output.button == button) {
-            if (binding->inputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
-                SDL_bool valid_input_range;
-
-                int value = SDL_JoystickGetAxis(gamecontroller->joystick, binding->input.axis.axis);
-                int threshold = binding->input.axis.axis_min + (binding->input.axis.axis_max - binding->input.axis.axis_min) / 2;
-                if (binding->input.axis.axis_min < binding->input.axis.axis_max) {
-                    valid_input_range = (value >= binding->input.axis.axis_min && value <= binding->input.axis.axis_max);
-                    if (valid_input_range) {
-                        return (value >= threshold) ? SDL_PRESSED : SDL_RELEASED;
-                    }
-                } else {
-                    valid_input_range = (value >= binding->input.axis.axis_max && value <= binding->input.axis.axis_min);
-                    if (valid_input_range) {
-                        return (value <= threshold) ? SDL_PRESSED : SDL_RELEASED;
-                    }
+        if (binding->inputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
+            SDL_bool valid_input_range;
+
+            int value = SDL_JoystickGetAxis(gamecontroller->joystick, binding->input.axis.axis);
+            int threshold = binding->input.axis.axis_min + (binding->input.axis.axis_max - binding->input.axis.axis_min) / 2;
+            if (binding->input.axis.axis_min < binding->input.axis.axis_max) {
+                valid_input_range = (value >= binding->input.axis.axis_min && value <= binding->input.axis.axis_max);
+                if (valid_input_range) {
+                    return (value >= threshold) ? SDL_PRESSED : SDL_RELEASED;
+                }
+            } else {
+                valid_input_range = (value >= binding->input.axis.axis_max && value <= binding->input.axis.axis_min);
+                if (valid_input_range) {
+                    return (value <= threshold) ? SDL_PRESSED : SDL_RELEASED;
                 }
-            } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_BUTTON) {
-                return SDL_JoystickGetButton(gamecontroller->joystick, binding->input.button);
-            } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_HAT) {
-                int hat_mask = SDL_JoystickGetHat(gamecontroller->joystick, binding->input.hat.hat);
-                return (hat_mask & binding->input.hat.hat_mask) ? SDL_PRESSED : SDL_RELEASED;
             }
+        } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_BUTTON) {
+            return SDL_JoystickGetButton(gamecontroller->joystick, binding->input.button);
+        } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_HAT) {
+            int hat_mask = SDL_JoystickGetHat(gamecontroller->joystick, binding->input.hat.hat);
+            return (hat_mask & binding->input.hat.hat_mask) ? SDL_PRESSED : SDL_RELEASED;
         }
     }
     return SDL_RELEASED;
 }
 
+/*
+ * Get the current state of a button on a controller
+ */
+Uint8
+SDL_GameControllerGetButton(SDL_GameController *gamecontroller, SDL_GameControllerButton button)
+{
+    Uint8 state;
+    int sequence;
+
+    if (!gamecontroller)
+        return 0;
+
+    if (button < 0 || button >= SDL_CONTROLLER_BUTTON_MAX)
+        return 0;
+
+    do {
+        sequence = SDL_PrivateJoystickBeginStateRead(gamecontroller->joystick);
+        state = SDL_PrivateGameControllerGetButtonState(gamecontroller, button);
+    } while (!SDL_PrivateJoystickEndStateRead(gamecontroller->joystick, sequence));
+
+    return state;
+}
+
 /**
  *  Get the number of touchpads on a game controller.
  */
@@ -2208,7 +2446,13 @@ int SDL_GameControllerSetSensorEnabled(SDL_GameController *gamecontroller, SDL_S
                 --joystick->nsensors_enabled;
             }
 
+            SDL_LockJoysticks();
             sensor->enabled = enabled;
+            if (!enabled) {
+                /* Don't hand out stale samples if the sensor is enabled again */
+                sensor->sample_count = 0;
+            }
+            SDL_UnlockJoysticks();
             return 0;
         }
     }
@@ -2281,6 +2525,43 @@ SDL_GameControllerGetSensorData(SDL_GameController *gamecontroller, SDL_SensorTy
     return SDL_Unsupported();
 }
 
+/*
+ *  Drain the buffered samples of a game controller sensor
+ */
+int
+SDL_GameControllerGetSensorSamples(SDL_GameController *gamecontroller, SDL_SensorType type, SDL_GameControllerSensorSample *samples, int max_samples)
+{
+    SDL_Joystick *joystick = SDL_GameControllerGetJoystick(gamecontroller);
+    int i, j, count;
+
+    if (!joystick) {
+        return SDL_InvalidParamError("gamecontroller");
+    }
+    if (!samples) {
+        return SDL_InvalidParamError("samples");
+    }
+    if (max_samples < 0) {
+        return SDL_InvalidParamError("max_samples");
+    }
+
+    for (i = 0; i < joystick->nsensors; ++i) {
+        SDL_JoystickSensorInfo *sensor = &joystick->sensors[i];
+
+        if (sensor->type == type) {
+            SDL_LockJoysticks();
+            count = SDL_min(max_samples, sensor->sample_count);
+            for (j = 0; j < count; ++j) {
+                samples[j] = sensor->samples[sensor->sample_head];
+                sensor->sample_head = (sensor->sample_head + 1) % SDL_JOYSTICK_SENSOR_SAMPLES;
+            }
+            sensor->sample_count -= count;
+            SDL_UnlockJoysticks();
+            return count;
+        }
+    }
+    return SDL_Unsupported();
+}
+
 const char *
 SDL_GameControllerName(SDL_GameController *gamecontroller)
 {
@@ -2409,23 +2690,21 @@ SDL_GameControllerButtonBind SDL_GameControllerGetBindForAxis(SDL_GameController
     SDL_GameControllerButtonBind bind;
     SDL_zero(bind);
 
-    if (!gamecontroller || axis == SDL_CONTROLLER_AXIS_INVALID)
+    if (!gamecontroller || axis < 0 || axis >= SDL_CONTROLLER_AXIS_MAX)
         return bind;
 
-    for (i = 0; i < gamecontroller->num_bindings; ++i) {
+    i = gamecontroller->axis_bindings[axis];
+    if (i >= 0) {
         SDL_ExtendedGameControllerBind *binding = &gamecontroller->bindings[i];
-        if (binding->outputType == SDL_CONTROLLER_BINDTYPE_AXIS && binding->output.axis.axis == axis) {
-            bind.bindType = binding->inputType;
-            if (binding->inputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
-                /* FIXME: There might be multiple axes bound now that we have axis ranges... */
-                bind.value.axis = binding->input.axis.axis;
-            } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_BUTTON) {
-                bind.value.button = binding->input.button;
-            } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_HAT) {
-                bind.value.hat.hat = binding->input.hat.hat;
-                bind.value.hat.hat_mask = binding->input.hat.hat_mask;
-            }
-            break;
+        bind.bindType = binding->inputType;
+        if (binding->inputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
+            /* FIXME: There might be multiple axes bound now that we have axis ranges... */
+            bind.value.axis = binding->input.axis.axis;
+        } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_BUTTON) {
+            bind.value.button = binding->input.button;
+        } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_HAT) {
+            bind.value.hat.hat = binding->input.hat.hat;
+            bind.value.hat.hat_mask = binding->input.hat.hat_mask;
         }
     }
     return bind;
@@ -2441,22 +2720,20 @@ SDL_GameControllerButtonBind SDL_GameControllerGetBindForButton(SDL_GameControll
     SDL_GameControllerButtonBind bind;
     SDL_zero(bind);
 
-    if (!gamecontroller || button == SDL_CONTROLLER_BUTTON_INVALID)
+    if (!gamecontroller || button < 0 || button >= SDL_CONTROLLER_BUTTON_MAX)
         return bind;
 
-    for (i = 0; i < gamecontroller->num_bindings; ++i) {
+    i = gamecontroller->button_bindings[button];
+    if (i >= 0) {
         SDL_ExtendedGameControllerBind *binding = &gamecontroller->bindings[i];
-        if (binding->outputType == SDL_CONTROLLER_BINDTYPE_BUTTON && binding->output.button == button) {
-            bind.bindType = binding->inputType;
-            if (binding->inputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
-                bind.value.axis = binding->input.axis.axis;
-            } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_BUTTON) {
-                bind.value.button = binding->input.button;
-            } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_HAT) {
-                bind.value.hat.hat = binding->input.hat.hat;
-                bind.value.hat.hat_mask = binding->input.hat.hat_mask;
-            }
-            break;
+        bind.bindType = binding->inputType;
+        if (binding->inputType == SDL_CONTROLLER_BINDTYPE_AXIS) {
+            bind.value.axis = binding->input.axis.axis;
+        } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_BUTTON) {
+            bind.value.button = binding->input.button;
+        } else if (binding->inputType == SDL_CONTROLLER_BINDTYPE_HAT) {
+            bind.value.hat.hat = binding->input.hat.hat;
+            bind.value.hat.hat_mask = binding->input.hat.hat_mask;
         }
     }
     return bind;
@@ -2542,6 +2819,7 @@ SDL_GameControllerClose(SDL_GameController *gamecontroller)
     SDL_free(gamecontroller->bindings);
     SDL_free(gamecontroller->last_match_axis);
     SDL_free(gamecontroller->last_hat_mask);
+    SDL_free(gamecontroller->input_axis_bindings);
     SDL_free(gamecontroller);
 
     SDL_UnlockJoysticks();
@@ -2565,15 +2843,13 @@ SDL_GameControllerQuit(void)
 void
 SDL_GameControllerQuitMappings(void)
 {
-    ControllerMapping_t *pControllerMap;
-
-    while (s_pSupportedControllers) {
-        pControllerMap = s_pSupportedControllers;
-        s_pSupportedControllers = s_pSupportedControllers->next;
-        SDL_free(pControllerMap->name);
-        SDL_free(pControllerMap->mapping);
-        SDL_free(pControllerMap);
-    }
+    /* The entries themselves are released along with the mapping memory */
+    SDL_PrivateFreeMappingMemory();
+    s_pSupportedControllers = NULL;
+    s_pSupportedControllersTail = NULL;
+    s_pDefaultMapping = NULL;
+    s_pXInputMapping = NULL;
+    SDL_zeroa(s_pMappingBuckets);
 
     SDL_DelEventWatch(SDL_GameControllerEventWatcher, NULL);
 
@@ -568,6 +568,16 @@ SDL_JoystickSetVirtualHat(SDL_Joystick *joystick, int hat, Uint8 value)
 #endif
 }
 
+int
+SDL_JoystickPlayVirtual(SDL_Joystick *joystick, const SDL_VirtualJoystickInput *inputs, int num_inputs, int rate, SDL_bool loop)
+{
+#if SDL_JOYSTICK_VIRTUAL
+    return SDL_JoystickPlayVirtualInner(joystick, inputs, num_inputs, rate, loop);
+#else
+    return SDL_SetError("SDL not built with virtual-joystick support");
+#endif
+}
+
 /*
  * Checks to make sure the joystick is valid.
  */
@@ -586,6 +596,43 @@ SDL_PrivateJoystickValid(SDL_Joystick *joystick)
     return valid;
 }
 
+/*
+ * The joystick state sequence is odd only while an input value is stored.
+ * Events are sent outside of that, so readers never wait on event watchers
+ * or other application code.
+ */
+static SDL_INLINE void
+SDL_PrivateJoystickBeginStateWrite(SDL_Joystick *joystick)
+{
+    SDL_AtomicAdd(&joystick->state_sequence, 1);
+}
+
+static SDL_INLINE void
+SDL_PrivateJoystickEndStateWrite(SDL_Joystick *joystick)
+{
+    SDL_AtomicAdd(&joystick->state_sequence, 1);
+}
+
+int
+SDL_PrivateJoystickBeginStateRead(SDL_Joystick *joystick)
+{
+    int sequence = SDL_AtomicGet(&joystick->state_sequence);
+
+    /* The writer only holds the sequence odd for a few stores */
+    while ((sequence & 1) != 0) {
+        SDL_Delay(0);
+        sequence = SDL_AtomicGet(&joystick->state_sequence);
+    }
+    return sequence;
+}
+
+SDL_bool
+SDL_PrivateJoystickEndStateRead(SDL_Joystick *joystick, int sequence)
+{
+    SDL_MemoryBarrierAcquire();
+    return (SDL_AtomicGet(&joystick->state_sequence) == sequence) ? SDL_TRUE : SDL_FALSE;
+}
+
 SDL_bool
 SDL_PrivateJoystickGetAutoGamepadMapping(int device_index, SDL_GamepadMapping * out)
 {
@@ -1112,6 +1159,9 @@ SDL_JoystickClose(SDL_Joystick *joystick)
         SDL_free(touchpad->fingers);
     }
     SDL_free(joystick->touchpads);
+    for (i = 0; i < joystick->nsensors; i++) {
+        SDL_free(joystick->sensors[i].samples);
+    }
     SDL_free(joystick->sensors);
     SDL_free(joystick);
 
@@ -1382,10 +1432,12 @@ SDL_PrivateJoystickAxis(SDL_Joystick *joystick, Uint8 axis, Sint16 value)
     info = &joystick->axes[axis];
     if (!info->has_initial_value ||
         (!info->has_second_value && (info->initial_value <= -32767 || info->initial_value == 32767) && SDL_abs(value) < (SDL_JOYSTICK_AXIS_MAX / 4))) {
+        SDL_PrivateJoystickBeginStateWrite(joystick);
         info->initial_value = value;
         info->value = value;
         info->zero = value;
         info->has_initial_value = SDL_TRUE;
+        SDL_PrivateJoystickEndStateWrite(joystick);
     } else if (value == info->value && !info->sending_initial_value) {
         return 0;
     } else {
@@ -1415,7 +1467,9 @@ SDL_PrivateJoystickAxis(SDL_Joystick *joystick, Uint8 axis, Sint16 value)
     }
 
     /* Update internal joystick state */
+    SDL_PrivateJoystickBeginStateWrite(joystick);
     info->value = value;
+    SDL_PrivateJoystickEndStateWrite(joystick);
 
     /* Post the event, if desired */
     posted = 0;
@@ -1455,7 +1509,9 @@ SDL_PrivateJoystickHat(SDL_Joystick *joystick, Uint8 hat, Uint8 value)
     }
 
     /* Update internal joystick state */
+    SDL_PrivateJoystickBeginStateWrite(joystick);
     joystick->hats[hat] = value;
+    SDL_PrivateJoystickEndStateWrite(joystick);
 
     /* Post the event, if desired */
     posted = 0;
@@ -1545,7 +1601,9 @@ SDL_PrivateJoystickButton(SDL_Joystick *joystick, Uint8 button, Uint8 state)
     }
 
     /* Update internal joystick state */
+    SDL_PrivateJoystickBeginStateWrite(joystick);
     joystick->buttons[button] = state;
+    SDL_PrivateJoystickEndStateWrite(joystick);
 
     /* Post the event, if desired */
     posted = 0;
@@ -2821,7 +2879,55 @@ int SDL_PrivateJoystickTouchpad(SDL_Joystick *joystick, int touchpad, int finger
     return posted;
 }
 
+Uint64 SDL_GetJoystickSensorTimestamp(void)
+{
+    const Uint64 now = SDL_GetPerformanceCounter();
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+
+    /* Split the conversion so high resolution counters don't overflow */
+    return (now / freq) * 1000000 + ((now % freq) * 1000000) / freq;
+}
+
 int SDL_PrivateJoystickSensor(SDL_Joystick *joystick, SDL_SensorType type, const float *data, int num_values)
+{
+    return SDL_PrivateJoystickSensorSample(joystick, type, SDL_GetJoystickSensorTimestamp(), data, num_values);
+}
+
+/* Drivers may update from their own threads, and the application drains
+   the samples from its thread, so the buffer is protected by the joystick lock */
+static void
+SDL_PrivateJoystickQueueSensorSample(SDL_JoystickSensorInfo *sensor, Uint64 timestamp_us, const float *data, int num_values)
+{
+    SDL_GameControllerSensorSample *sample;
+
+    SDL_LockJoysticks();
+
+    if (!sensor->samples) {
+        sensor->samples = (SDL_GameControllerSensorSample *)SDL_malloc(SDL_JOYSTICK_SENSOR_SAMPLES * sizeof(*sensor->samples));
+        if (!sensor->samples) {
+            SDL_UnlockJoysticks();
+            return;
+        }
+        sensor->sample_head = 0;
+        sensor->sample_count = 0;
+    }
+
+    if (sensor->sample_count == SDL_JOYSTICK_SENSOR_SAMPLES) {
+        /* The buffer is full, drop the oldest sample */
+        sensor->sample_head = (sensor->sample_head + 1) % SDL_JOYSTICK_SENSOR_SAMPLES;
+        --sensor->sample_count;
+    }
+
+    sample = &sensor->samples[(sensor->sample_head + sensor->sample_count) % SDL_JOYSTICK_SENSOR_SAMPLES];
+    sample->timestamp_us = timestamp_us;
+    SDL_zeroa(sample->data);
+    SDL_memcpy(sample->data, data, num_values*sizeof(*data));
+    ++sensor->sample_count;
+
+    SDL_UnlockJoysticks();
+}
+
+int SDL_PrivateJoystickSensorSample(SDL_Joystick *joystick, SDL_SensorType type, Uint64 timestamp_us, const float *data, int num_values)
 {
     int i;
     int posted = 0;
@@ -2840,6 +2946,7 @@ int SDL_PrivateJoystickSensor(SDL_Joystick *joystick, SDL_SensorType type, const
 
                 /* Update internal sensor state */
                 SDL_memcpy(sensor->data, data, num_values*sizeof(*data));
+                SDL_PrivateJoystickQueueSensorSample(sensor, timestamp_us, data, num_values);
 
                 /* Post the event, if desired */
 #if !SDL_EVENTS_DISABLED
@@ -131,12 +131,26 @@ extern int SDL_PrivateJoystickTouchpad(SDL_Joystick *joystick,
                                        int touchpad, int finger, Uint8 state, float x, float y, float pressure);
 extern int SDL_PrivateJoystickSensor(SDL_Joystick *joystick,
                                      SDL_SensorType type, const float *data, int num_values);
+extern int SDL_PrivateJoystickSensorSample(SDL_Joystick *joystick,
+                                           SDL_SensorType type, Uint64 timestamp_us, const float *data, int num_values);
 extern void SDL_PrivateJoystickBatteryLevel(SDL_Joystick *joystick,
                                             SDL_JoystickPowerLevel ePowerLevel);
 
+/* Get the current time on the clock used for sensor sample timestamps */
+extern Uint64 SDL_GetJoystickSensorTimestamp(void);
+
 /* Internal sanity checking functions */
 extern SDL_bool SDL_PrivateJoystickValid(SDL_Joystick *joystick);
 
+/* Functions to read several joystick inputs consistently without the joystick lock:
+    do {
+        sequence = SDL_PrivateJoystickBeginStateRead(joystick);
+        ... read state ...
+    } while (!SDL_PrivateJoystickEndStateRead(joystick, sequence));
+ */
+extern int SDL_PrivateJoystickBeginStateRead(SDL_Joystick *joystick);
+extern SDL_bool SDL_PrivateJoystickEndStateRead(SDL_Joystick *joystick, int sequence);
+
 typedef enum
 {
     EMappingKind_None = 0,
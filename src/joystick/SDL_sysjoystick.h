@@ -24,7 +24,9 @@
 #define SDL_sysjoystick_h_
 
 /* This is the system specific header for the SDL joystick API */
+#include "SDL_atomic.h"
 #include "SDL_joystick.h"
+#include "SDL_thread.h"
 #include "SDL_joystick_c.h"
 
 /* The SDL joystick structure */
@@ -53,12 +55,20 @@ typedef struct _SDL_JoystickTouchpadInfo
     SDL_JoystickTouchpadFingerInfo *fingers;
 } SDL_JoystickTouchpadInfo;
 
+/* The number of sensor samples buffered for SDL_GameControllerGetSensorSamples() */
+#define SDL_JOYSTICK_SENSOR_SAMPLES 256
+
 typedef struct _SDL_JoystickSensorInfo
 {
     SDL_SensorType type;
     SDL_bool enabled;
     float rate;
     float data[3];      /* If this needs to expand, update SDL_ControllerSensorEvent */
+
+    /* Ring buffer of recent samples, allocated when the first sample arrives */
+    SDL_GameControllerSensorSample *samples;
+    int sample_head;
+    int sample_count;
 } SDL_JoystickSensorInfo;
 
 struct _SDL_Joystick
@@ -103,6 +113,8 @@ struct _SDL_Joystick
     Uint8 led_blue;
     Uint32 led_expiration;
 
+    SDL_atomic_t state_sequence; /* Odd while an input value is being stored */
+
     SDL_bool attached;
     SDL_bool is_game_controller;
     SDL_bool delayed_guide_button; /* SDL_TRUE if this device has the guide button event delayed */
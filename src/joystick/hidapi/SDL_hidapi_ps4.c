@@ -540,6 +540,9 @@ HIDAPI_DriverPS4_OpenJoystick(SDL_HIDAPI_Device *device, SDL_Joystick *joystick)
 #ifdef DEBUG_PS4
     SDL_Log("PS4 dongle = %s, bluetooth = %s\n", ctx->is_dongle ? "TRUE" : "FALSE", ctx->is_bluetooth ? "TRUE" : "FALSE");
 #endif
+    if (ctx->is_bluetooth) {
+        device->rumble_interval = SDL_HIDAPI_RUMBLE_INTERVAL_BLUETOOTH;
+    }
 
     /* Check to see if audio is supported */
     if (device->vendor_id == USB_VENDOR_SONY &&
@@ -589,6 +589,9 @@ HIDAPI_DriverPS5_OpenJoystick(SDL_HIDAPI_Device *device, SDL_Joystick *joystick)
         enhanced_mode = SDL_GetHintBoolean(SDL_HINT_JOYSTICK_HIDAPI_PS5_RUMBLE,
                                            SDL_GetHintBoolean(SDL_HINT_JOYSTICK_HIDAPI_PS4_RUMBLE, SDL_FALSE));
     }
+    if (ctx->is_bluetooth) {
+        device->rumble_interval = SDL_HIDAPI_RUMBLE_INTERVAL_BLUETOOTH;
+    }
 
     if (enhanced_mode) {
         /* Read the serial number (Bluetooth address in reverse byte order)
@@ -742,6 +745,7 @@ HIDAPI_DriverPS5_SendJoystickEffect(SDL_HIDAPI_Device *device, SDL_Joystick *joy
             effects->ucEnableBits2 == pending_effects->ucEnableBits2) {
             /* We're simply updating the data for this request */
             SDL_memcpy(pending_data, data, report_size);
+            ++device->rumble_merged;
             SDL_HIDAPI_UnlockRumble();
             return 0;
         }
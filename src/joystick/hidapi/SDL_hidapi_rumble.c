@@ -53,6 +53,39 @@ typedef struct SDL_HIDAPI_RumbleContext
 
 static SDL_HIDAPI_RumbleContext rumble_context;
 
+/* Find the oldest request for a device that is ready to send, and remove it from the queue */
+static SDL_HIDAPI_RumbleRequest *
+SDL_HIDAPI_GetNextRumbleLocked(SDL_HIDAPI_RumbleContext *ctx, Uint32 now, Uint32 *wait)
+{
+    SDL_HIDAPI_RumbleRequest *request, *older = NULL;
+
+    *wait = 0;
+    for (request = ctx->requests_tail; request; older = request, request = request->prev) {
+        SDL_HIDAPI_Device *device = request->device;
+        Uint32 interval = device->rumble_interval ? device->rumble_interval : SDL_HIDAPI_RUMBLE_INTERVAL_DEFAULT;
+        /* Unsigned elapsed time stays correct across SDL_GetTicks() wraparound */
+        Uint32 elapsed = now - device->rumble_last_send;
+        Uint32 remaining;
+
+        if (!device->rumble_has_last_send || elapsed >= interval) {
+            if (older) {
+                older->prev = request->prev;
+            } else {
+                ctx->requests_tail = request->prev;
+            }
+            if (request == ctx->requests_head) {
+                ctx->requests_head = older;
+            }
+            return request;
+        }
+        remaining = interval - elapsed;
+        if (*wait == 0 || remaining < *wait) {
+            *wait = remaining;
+        }
+    }
+    return NULL;
+}
+
 static int SDL_HIDAPI_RumbleThread(void *data)
 {
     SDL_HIDAPI_RumbleContext *ctx = (SDL_HIDAPI_RumbleContext *)data;
@@ -61,34 +94,45 @@ static int SDL_HIDAPI_RumbleThread(void *data)
 
     while (SDL_AtomicGet(&ctx->running)) {
         SDL_HIDAPI_RumbleRequest *request = NULL;
-
-        SDL_SemWait(ctx->request_sem);
+        SDL_HIDAPI_Device *device;
+        Uint32 wait;
 
         SDL_LockMutex(ctx->lock);
-        request = ctx->requests_tail;
-        if (request) {
-            if (request == ctx->requests_head) {
-                ctx->requests_head = NULL;
+        request = SDL_HIDAPI_GetNextRumbleLocked(ctx, SDL_GetTicks(), &wait);
+        SDL_UnlockMutex(ctx->lock);
+
+        if (!request) {
+            /* Sleep until a device is ready or a new request comes in.
+               Until then, new data for a waiting device is merged into its pending request.
+             */
+            if (wait) {
+                SDL_SemWaitTimeout(ctx->request_sem, wait);
+            } else {
+                SDL_SemWait(ctx->request_sem);
             }
-            ctx->requests_tail = request->prev;
+            continue;
         }
-        SDL_UnlockMutex(ctx->lock);
 
-        if (request) {
-            SDL_LockMutex(request->device->dev_lock);
-            if (request->device->dev) {
+        device = request->device;
+
+        SDL_LockMutex(device->dev_lock);
+        if (device->dev) {
 #ifdef DEBUG_RUMBLE
-                HIDAPI_DumpPacket("Rumble packet: size = %d", request->data, request->size);
+            HIDAPI_DumpPacket("Rumble packet: size = %d", request->data, request->size);
 #endif
-                SDL_hid_write(request->device->dev, request->data, request->size);
-            }
-            SDL_UnlockMutex(request->device->dev_lock);
-            (void)SDL_AtomicDecRef(&request->device->rumble_pending);
-            SDL_free(request);
-
-            /* Make sure we're not starving report reads when there's lots of rumble */
-            SDL_Delay(10);
+            SDL_hid_write(device->dev, request->data, request->size);
+            ++device->rumble_sent;
+        } else {
+            ++device->rumble_dropped;
         }
+        SDL_UnlockMutex(device->dev_lock);
+
+        /* Make sure we're not starving report reads when there's lots of rumble */
+        device->rumble_last_send = SDL_GetTicks();
+        device->rumble_has_last_send = SDL_TRUE;
+
+        (void)SDL_AtomicDecRef(&device->rumble_pending);
+        SDL_free(request);
     }
     return 0;
 }
@@ -116,6 +160,7 @@ SDL_HIDAPI_StopRumbleThread(SDL_HIDAPI_RumbleContext *ctx)
         }
         ctx->requests_tail = request->prev;
 
+        ++request->device->rumble_dropped;
         (void)SDL_AtomicDecRef(&request->device->rumble_pending);
         SDL_free(request);
     }
@@ -244,15 +289,12 @@ int SDL_HIDAPI_SendRumble(SDL_HIDAPI_Device *device, const Uint8 *data, int size
         return -1;
     }
 
-    /* check if there is a pending request for the device and update it */
-    if (SDL_HIDAPI_GetPendingRumbleLocked(device, &pending_data, &pending_size, &maximum_size)) {
-        if (size > maximum_size) {
-            SDL_HIDAPI_UnlockRumble();
-            return SDL_SetError("Couldn't send rumble, size %d is greater than %d", size, maximum_size);
-        }
-
+    /* check if there is a pending request of the same report for the device and update it,
+       a pending report of a different kind (e.g. an LED report) is left alone */
+    if (SDL_HIDAPI_GetPendingRumbleLocked(device, &pending_data, &pending_size, &maximum_size) &&
+        *pending_size == size && size > 0 && pending_data[0] == data[0]) {
         SDL_memcpy(pending_data, data, size);
-        *pending_size = size;
+        ++device->rumble_merged;
         SDL_HIDAPI_UnlockRumble();
         return size;
     }
@@ -24,6 +24,12 @@
 
 /* Handle rumble on a separate thread so it doesn't block the application */
 
+/* Minimum time between output reports on a device, in milliseconds.
+   Reports for a device that is waiting are merged, the most recent data wins.
+ */
+#define SDL_HIDAPI_RUMBLE_INTERVAL_DEFAULT      10
+#define SDL_HIDAPI_RUMBLE_INTERVAL_BLUETOOTH    20
+
 /* Advanced API */
 int SDL_HIDAPI_LockRumble(void);
 SDL_bool SDL_HIDAPI_GetPendingRumbleLocked(SDL_HIDAPI_Device *device, Uint8 **data, int **size, int *maximum_size);
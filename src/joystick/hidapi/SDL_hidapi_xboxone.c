@@ -332,6 +332,9 @@ HIDAPI_DriverXboxOne_OpenJoystick(SDL_HIDAPI_Device *device, SDL_Joystick *joyst
     ctx->vendor_id = device->vendor_id;
     ctx->product_id = device->product_id;
     ctx->bluetooth = SDL_IsJoystickBluetoothXboxOne(device->vendor_id, device->product_id);
+    if (ctx->bluetooth) {
+        device->rumble_interval = SDL_HIDAPI_RUMBLE_INTERVAL_BLUETOOTH;
+    }
     ctx->start_time = SDL_GetTicks();
     ctx->sequence = 1;
     ctx->has_color_led = ControllerHasColorLED(ctx->vendor_id, ctx->product_id);
@@ -31,6 +31,7 @@
 #include "SDL_hidapijoystick_c.h"
 #include "SDL_hidapi_rumble.h"
 #include "../../SDL_hints_c.h"
+#include "../../hidapi/SDL_hidapi_c.h"
 
 #if defined(__WIN32__)
 #include "../windows/SDL_rawinputjoystick_c.h"
@@ -79,6 +80,7 @@ static SDL_HIDAPI_Device *SDL_HIDAPI_devices;
 static int SDL_HIDAPI_numjoysticks = 0;
 static SDL_bool initialized = SDL_FALSE;
 static SDL_bool shutting_down = SDL_FALSE;
+static SDL_bool SDL_HIDAPI_read_thread = SDL_FALSE;
 
 void
 HIDAPI_DumpPacket(const char *prefix, Uint8 *data, int size)
@@ -183,18 +185,26 @@ HIDAPI_GetDeviceByIndex(int device_index, SDL_JoystickID *pJoystickID)
     return NULL;
 }
 
+/* Devices are kept in enumeration order, so when walking a new enumeration
+   the device after the previous match is usually the next one we want. */
 static SDL_HIDAPI_Device *
-HIDAPI_GetJoystickByInfo(const char *path, Uint16 vendor_id, Uint16 product_id)
+HIDAPI_GetJoystickByInfoFrom(SDL_HIDAPI_Device *hint, const char *path, Uint16 vendor_id, Uint16 product_id)
 {
-    SDL_HIDAPI_Device *device = SDL_HIDAPI_devices;
-    while (device) {
+    SDL_HIDAPI_Device *device;
+
+    for (device = hint; device; device = device->next) {
         if (device->vendor_id == vendor_id && device->product_id == product_id &&
             SDL_strcmp(device->path, path) == 0) {
-            break;
+            return device;
         }
-        device = device->next;
     }
-    return device;
+    for (device = SDL_HIDAPI_devices; device != hint; device = device->next) {
+        if (device->vendor_id == vendor_id && device->product_id == product_id &&
+            SDL_strcmp(device->path, path) == 0) {
+            return device;
+        }
+    }
+    return NULL;
 }
 
 static void
@@ -312,6 +322,8 @@ HIDAPI_JoystickInit(void)
         return SDL_SetError("Couldn't initialize hidapi");
     }
 
+    SDL_HIDAPI_read_thread = SDL_GetHintBoolean(SDL_HINT_JOYSTICK_HIDAPI_THREAD, SDL_FALSE);
+
     for (i = 0; i < SDL_arraysize(SDL_HIDAPI_drivers); ++i) {
         SDL_HIDAPI_DeviceDriver *driver = SDL_HIDAPI_drivers[i];
         SDL_AddHintCallback(driver->hint, SDL_HIDAPIDriverHintChanged, NULL);
@@ -556,6 +568,12 @@ HIDAPI_DelDevice(SDL_HIDAPI_Device *device)
                 SDL_Delay(10);
             }
 
+            if (device->rumble_sent || device->rumble_merged || device->rumble_dropped) {
+                SDL_LogDebug(SDL_LOG_CATEGORY_INPUT,
+                             "HIDAPI device '%s' output reports: %d sent, %d merged, %d dropped",
+                             device->name, device->rumble_sent, device->rumble_merged, device->rumble_dropped);
+            }
+
             SDL_DestroyMutex(device->dev_lock);
             SDL_free(device->serial);
             SDL_free(device->name);
@@ -585,10 +603,13 @@ HIDAPI_UpdateDeviceList(void)
     if (SDL_HIDAPI_numdrivers > 0) {
         devs = SDL_hid_enumerate(0, 0);
         if (devs) {
+            SDL_HIDAPI_Device *hint = SDL_HIDAPI_devices;
+
             for (info = devs; info; info = info->next) {
-                device = HIDAPI_GetJoystickByInfo(info->path, info->vendor_id, info->product_id);
+                device = HIDAPI_GetJoystickByInfoFrom(hint, info->path, info->vendor_id, info->product_id);
                 if (device) {
                     device->seen = SDL_TRUE;
+                    hint = device->next;
                 } else {
                     HIDAPI_AddDevice(info);
                 }
@@ -756,6 +777,10 @@ HIDAPI_UpdateDevices(void)
         while (device) {
             if (device->driver) {
                 if (SDL_TryLockMutex(device->dev_lock) == 0) {
+                    if (SDL_HIDAPI_read_thread && device->dev) {
+                        /* Queue reports as they arrive, they're still parsed here */
+                        SDL_hid_start_read_thread(device->dev);
+                    }
                     device->updating = SDL_TRUE;
                     device->driver->UpdateDevice(device);
                     device->updating = SDL_FALSE;
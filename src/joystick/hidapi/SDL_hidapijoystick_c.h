@@ -72,6 +72,12 @@ typedef struct _SDL_HIDAPI_Device
     SDL_mutex *dev_lock;
     SDL_hid_device *dev;
     SDL_atomic_t rumble_pending;
+    Uint32 rumble_interval;     /* Minimum time between output reports, 0 for the default */
+    SDL_bool rumble_has_last_send;  /* SDL_TRUE once rumble_last_send is valid */
+    Uint32 rumble_last_send;    /* Time the last output report was processed */
+    int rumble_sent;            /* Number of output reports written to the device */
+    int rumble_merged;          /* Number of reports merged into a pending report */
+    int rumble_dropped;         /* Number of reports discarded without being written */
     int num_joysticks;
     SDL_JoystickID *joysticks;
 
@@ -35,6 +35,9 @@
 #ifdef HAVE_INOTIFY
 #include <sys/inotify.h>
 #endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <dirent.h>
@@ -111,6 +114,10 @@ typedef struct SDL_joylist_item
 
     SDL_bool checked_mapping;
     SDL_GamepadMapping *mapping;
+
+    /* Axis info cached from the first open, so reopening doesn't reprobe every axis */
+    unsigned long absinfo_valid[NBITS(ABS_MAX)];
+    struct input_absinfo *absinfo;
 } SDL_joylist_item;
 
 static SDL_bool SDL_classic_joysticks = SDL_FALSE;
@@ -122,6 +129,67 @@ static int inotify_fd = -1;
 static Uint32 last_joy_detect_time;
 static time_t last_input_dir_mtime;
 
+#ifdef HAVE_SYS_EPOLL_H
+/* When epoll is used, the joystick and inotify fds are waited on together once per update */
+static int epoll_fd = -1;
+static SDL_bool epoll_polled = SDL_FALSE;
+static SDL_bool inotify_pending = SDL_FALSE;
+
+/* Returns 0 if epoll reports input on the fd, or -1 if it has to be read on every update */
+static int
+LINUX_EpollAdd(int fd, void *data)
+{
+    if (epoll_fd >= 0 && fd >= 0) {
+        struct epoll_event event;
+
+        SDL_zero(event);
+        event.events = EPOLLIN;
+        event.data.ptr = data;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_INPUT, "Unable to add joystick to epoll: %s", strerror(errno));
+            return -1;
+        }
+        return 0;
+    }
+    return -1;
+}
+
+static void
+LINUX_EpollRemove(int fd)
+{
+    if (epoll_fd >= 0 && fd >= 0) {
+        struct epoll_event event; /* Needed before Linux 2.6.9 */
+
+        SDL_zero(event);
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, &event);
+    }
+}
+
+/* Find out which devices have input waiting, once between each device detection */
+static void
+LINUX_EpollPoll(void)
+{
+    struct epoll_event events[64];
+    int i, count;
+
+    if (epoll_fd < 0 || epoll_polled) {
+        return;
+    }
+    epoll_polled = SDL_TRUE;
+
+    /* Devices that don't fit are reported again next time, the fds are level triggered */
+    count = epoll_wait(epoll_fd, events, SDL_arraysize(events), 0);
+    for (i = 0; i < count; ++i) {
+        if (events[i].data.ptr) {
+            struct joystick_hwdata *hwdata = (struct joystick_hwdata *)events[i].data.ptr;
+            hwdata->pending = SDL_TRUE;
+        } else {
+            inotify_pending = SDL_TRUE;
+        }
+    }
+}
+#endif /* HAVE_SYS_EPOLL_H */
+
 static void
 FixupDeviceInfoForMapping(int fd, struct input_id *inpid)
 {
@@ -297,6 +365,7 @@ static void
 FreeJoylistItem(SDL_joylist_item *item)
 {
     SDL_free(item->mapping);
+    SDL_free(item->absinfo);
     SDL_free(item->path);
     SDL_free(item->name);
     SDL_free(item);
@@ -635,38 +704,56 @@ filter_entries(const struct dirent *entry)
 {
     return IsJoystickDeviceNode(entry->d_name);
 }
-static int
-sort_entries(const void *_a, const void *_b)
+/* Compute the sort key for a device node once, since looking up the
+ * joystick index of an event device has to scan its sysfs directory.
+ * Devices with a joystick index come first, in joystick order. */
+static Uint32
+sort_entry_key(const struct dirent *entry)
 {
-    const struct dirent **a = (const struct dirent **)_a;
-    const struct dirent **b = (const struct dirent **)_b;
-    int numA, numB;
-    int offset;
+    int num;
 
     if (SDL_classic_joysticks) {
-        offset = 2; /* strlen("js") */
-        numA = SDL_atoi((*a)->d_name+offset);
-        numB = SDL_atoi((*b)->d_name+offset);
+        num = SDL_atoi(entry->d_name + 2); /* strlen("js") */
     } else {
-        offset = 5; /* strlen("event") */
-        numA = SDL_atoi((*a)->d_name+offset);
-        numB = SDL_atoi((*b)->d_name+offset);
+        int js;
+
+        num = SDL_atoi(entry->d_name + 5); /* strlen("event") */
 
         /* See if we can get the joystick ordering */
-        {
-            int jsA = get_event_joystick_index(numA);
-            int jsB = get_event_joystick_index(numB);
-            if (jsA >= 0 && jsB >= 0) {
-                numA = jsA;
-                numB = jsB;
-            } else if (jsA >= 0) {
-                return -1;
-            } else if (jsB >= 0) {
-                return 1;
-            }
+        js = get_event_joystick_index(num);
+        if (js >= 0) {
+            num = js;
+        } else {
+            return 0x80000000u | (Uint32)num;
         }
     }
-    return (numA - numB);
+    return (Uint32)num;
+}
+
+static void
+sort_entries(struct dirent **entries, int count)
+{
+    SDL_SortKey *keys;
+    struct dirent **sorted;
+    int i;
+
+    keys = (SDL_SortKey *)SDL_malloc(count * (sizeof(*keys) + sizeof(*sorted)));
+    if (!keys) {
+        return; /* Leave them in directory order */
+    }
+    sorted = (struct dirent **)(keys + count);
+
+    for (i = 0; i < count; ++i) {
+        keys[i].key = sort_entry_key(entries[i]);
+        keys[i].index = (Uint32)i;
+    }
+    SDL_qsort_keys(keys, count);
+
+    for (i = 0; i < count; ++i) {
+        sorted[i] = entries[keys[i].index];
+    }
+    SDL_memcpy(entries, sorted, count * sizeof(*sorted));
+    SDL_free(keys);
 }
 
 static void
@@ -686,7 +773,7 @@ LINUX_FallbackJoystickDetect(void)
 
             count = scandir("/dev/input", &entries, filter_entries, NULL);
             if (count > 1) {
-                qsort(entries, count, sizeof(*entries), sort_entries);
+                sort_entries(entries, count);
             }
             for (i = 0; i < count; ++i) {
                 SDL_snprintf(path, SDL_arraysize(path), "/dev/input/%s", entries[i]->d_name);
@@ -714,6 +801,15 @@ LINUX_JoystickDetect(void)
 #endif
 #ifdef HAVE_INOTIFY
     if (inotify_fd >= 0 && last_joy_detect_time != 0) {
+#ifdef HAVE_SYS_EPOLL_H
+        if (epoll_fd >= 0) {
+            LINUX_EpollPoll();
+            if (inotify_pending) {
+                inotify_pending = SDL_FALSE;
+                LINUX_InotifyJoystickDetect();
+            }
+        } else
+#endif
         LINUX_InotifyJoystickDetect();
     }
     else
@@ -722,6 +818,11 @@ LINUX_JoystickDetect(void)
         LINUX_FallbackJoystickDetect();
     }
 
+#ifdef HAVE_SYS_EPOLL_H
+    /* The next update polls again */
+    epoll_polled = SDL_FALSE;
+#endif
+
     HandlePendingRemovals();
 
     SDL_UpdateSteamControllers();
@@ -827,6 +928,27 @@ LINUX_JoystickInit(void)
 #endif /* HAVE_INOTIFY */
     }
 
+#ifdef HAVE_SYS_EPOLL_H
+    if (SDL_GetHintBoolean(SDL_HINT_LINUX_JOYSTICK_EPOLL, SDL_FALSE)) {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_INPUT,
+                        "Unable to initialize epoll, reading joysticks on every update: %s",
+                        strerror (errno));
+        } else {
+            epoll_polled = SDL_FALSE;
+            inotify_pending = SDL_FALSE;
+
+            /* The inotify fd is the only one without data */
+            if (inotify_fd >= 0 && LINUX_EpollAdd(inotify_fd, NULL) < 0) {
+                /* Device changes would never be noticed, don't use epoll at all */
+                close(epoll_fd);
+                epoll_fd = -1;
+            }
+        }
+    }
+#endif
+
     return 0;
 }
 
@@ -921,6 +1043,28 @@ allocate_balldata(SDL_Joystick *joystick)
     return (0);
 }
 
+static int
+GetAbsInfo(SDL_joylist_item *item, int fd, int code, struct input_absinfo *absinfo)
+{
+    if (item->absinfo && test_bit(code, item->absinfo_valid)) {
+        *absinfo = item->absinfo[code];
+        return 0;
+    }
+
+    if (ioctl(fd, EVIOCGABS(code), absinfo) < 0) {
+        return -1;
+    }
+
+    if (!item->absinfo) {
+        item->absinfo = (struct input_absinfo *)SDL_calloc(ABS_MAX, sizeof(*item->absinfo));
+    }
+    if (item->absinfo) {
+        item->absinfo[code] = *absinfo;
+        item->absinfo_valid[EVDEV_LONG(code)] |= (1UL << EVDEV_OFF(code));
+    }
+    return 0;
+}
+
 static void
 ConfigJoystick(SDL_Joystick *joystick, int fd)
 {
@@ -945,6 +1089,7 @@ ConfigJoystick(SDL_Joystick *joystick, int fd)
 #endif
                 joystick->hwdata->key_map[i] = joystick->nbuttons;
                 joystick->hwdata->has_key[i] = SDL_TRUE;
+                joystick->hwdata->key_codes[joystick->hwdata->nkey_codes++] = (Uint16)i;
                 ++joystick->nbuttons;
             }
         }
@@ -955,6 +1100,7 @@ ConfigJoystick(SDL_Joystick *joystick, int fd)
 #endif
                 joystick->hwdata->key_map[i] = joystick->nbuttons;
                 joystick->hwdata->has_key[i] = SDL_TRUE;
+                joystick->hwdata->key_codes[joystick->hwdata->nkey_codes++] = (Uint16)i;
                 ++joystick->nbuttons;
             }
         }
@@ -968,7 +1114,7 @@ ConfigJoystick(SDL_Joystick *joystick, int fd)
                 struct input_absinfo absinfo;
                 struct axis_correct *correct = &joystick->hwdata->abs_correct[i];
 
-                if (ioctl(fd, EVIOCGABS(i), &absinfo) < 0) {
+                if (GetAbsInfo(joystick->hwdata->item, fd, i, &absinfo) < 0) {
                     continue;
                 }
 #ifdef DEBUG_INPUT_EVENTS
@@ -979,6 +1125,7 @@ ConfigJoystick(SDL_Joystick *joystick, int fd)
 #endif /* DEBUG_INPUT_EVENTS */
                 joystick->hwdata->abs_map[i] = joystick->naxes;
                 joystick->hwdata->has_abs[i] = SDL_TRUE;
+                joystick->hwdata->abs_codes[joystick->hwdata->nabs_codes++] = (Uint8)i;
 
                 correct->minimum = absinfo.minimum;
                 correct->maximum = absinfo.maximum;
@@ -1008,7 +1155,7 @@ ConfigJoystick(SDL_Joystick *joystick, int fd)
                 struct input_absinfo absinfo;
                 int hat_index = (i - ABS_HAT0X) / 2;
 
-                if (ioctl(fd, EVIOCGABS(i), &absinfo) < 0) {
+                if (GetAbsInfo(joystick->hwdata->item, fd, i, &absinfo) < 0) {
                     continue;
                 }
 #ifdef DEBUG_INPUT_EVENTS
@@ -1187,6 +1334,12 @@ LINUX_JoystickOpen(SDL_Joystick *joystick, int device_index)
     SDL_assert(item->hwdata == NULL);
     item->hwdata = joystick->hwdata;
 
+#ifdef HAVE_SYS_EPOLL_H
+    if (LINUX_EpollAdd(joystick->hwdata->fd, joystick->hwdata) == 0) {
+        joystick->hwdata->epoll_managed = SDL_TRUE;
+    }
+#endif
+
     /* mark joystick as fresh and ready */
     joystick->hwdata->fresh = SDL_TRUE;
 
@@ -1340,28 +1493,25 @@ AxisCorrect(SDL_Joystick *joystick, int which, int value)
 static void
 PollAllValues(SDL_Joystick *joystick)
 {
+    struct joystick_hwdata *hwdata = joystick->hwdata;
     struct input_absinfo absinfo;
     unsigned long keyinfo[NBITS(KEY_MAX)];
-    int i;
+    int i, code;
 
-    /* Poll all axis */
-    for (i = ABS_X; i < ABS_MAX; i++) {
-        if (i == ABS_HAT0X) {  /* we handle hats in the next loop, skip them for now. */
-            i = ABS_HAT3Y;
-            continue;
-        }
-        if (joystick->hwdata->has_abs[i]) {
-            if (ioctl(joystick->hwdata->fd, EVIOCGABS(i), &absinfo) >= 0) {
-                absinfo.value = AxisCorrect(joystick, i, absinfo.value);
+    /* Poll all axis. There is no bulk query for axis values, but we only
+       visit the axes the device actually has. */
+    for (i = 0; i < hwdata->nabs_codes; i++) {
+        code = hwdata->abs_codes[i];
+        if (ioctl(hwdata->fd, EVIOCGABS(code), &absinfo) >= 0) {
+            absinfo.value = AxisCorrect(joystick, code, absinfo.value);
 
 #ifdef DEBUG_INPUT_EVENTS
-                SDL_Log("Joystick : Re-read Axis %d (%d) val= %d\n",
-                    joystick->hwdata->abs_map[i], i, absinfo.value);
+            SDL_Log("Joystick : Re-read Axis %d (%d) val= %d\n",
+                hwdata->abs_map[code], code, absinfo.value);
 #endif
-                SDL_PrivateJoystickAxis(joystick,
-                        joystick->hwdata->abs_map[i],
-                        absinfo.value);
-            }
+            SDL_PrivateJoystickAxis(joystick,
+                    hwdata->abs_map[code],
+                    absinfo.value);
         }
     }
 
@@ -1378,20 +1528,23 @@ PollAllValues(SDL_Joystick *joystick)
         }
     }
 
-    /* Poll all buttons */
+    /* Poll all buttons with a single bitmask query, and only report the
+       buttons that differ from the state we last reported. */
     SDL_zeroa(keyinfo);
-    if (ioctl(joystick->hwdata->fd, EVIOCGKEY(sizeof (keyinfo)), keyinfo) >= 0) {
-        for (i = 0; i < KEY_MAX; i++) {
-            if (joystick->hwdata->has_key[i]) {
-                const Uint8 value = test_bit(i, keyinfo) ? SDL_PRESSED : SDL_RELEASED;
+    if (ioctl(hwdata->fd, EVIOCGKEY(sizeof (keyinfo)), keyinfo) >= 0) {
+        for (i = 0; i < hwdata->nkey_codes; i++) {
+            code = hwdata->key_codes[i];
+            if (test_bit(code, keyinfo) != test_bit(code, hwdata->key_state)) {
+                const Uint8 value = test_bit(code, keyinfo) ? SDL_PRESSED : SDL_RELEASED;
 #ifdef DEBUG_INPUT_EVENTS
                 SDL_Log("Joystick : Re-read Button %d (%d) val= %d\n",
-                    joystick->hwdata->key_map[i], i, value);
+                    hwdata->key_map[code], code, value);
 #endif
                 SDL_PrivateJoystickButton(joystick,
-                        joystick->hwdata->key_map[i], value);
+                        hwdata->key_map[code], value);
             }
         }
+        SDL_memcpy(hwdata->key_state, keyinfo, sizeof(keyinfo));
     }
 
     /* Joyballs are relative input, so there's no poll state. Events only! */
@@ -1422,6 +1575,13 @@ HandleInputEvents(SDL_Joystick *joystick)
 
             switch (events[i].type) {
             case EV_KEY:
+                if (code < KEY_MAX) {
+                    if (events[i].value) {
+                        joystick->hwdata->key_state[EVDEV_LONG(code)] |= (1UL << EVDEV_OFF(code));
+                    } else {
+                        joystick->hwdata->key_state[EVDEV_LONG(code)] &= ~(1UL << EVDEV_OFF(code));
+                    }
+                }
                 SDL_PrivateJoystickButton(joystick,
                                           joystick->hwdata->key_map[code],
                                           events[i].value);
@@ -1533,16 +1693,28 @@ static void
 LINUX_JoystickUpdate(SDL_Joystick *joystick)
 {
     int i;
+    SDL_bool has_input = SDL_TRUE;
 
     if (joystick->hwdata->m_bSteamController) {
         SDL_UpdateSteamController(joystick);
         return;
     }
 
-    if (joystick->hwdata->classic) {
-        HandleClassicEvents(joystick);
-    } else {
-        HandleInputEvents(joystick);
+#ifdef HAVE_SYS_EPOLL_H
+    if (epoll_fd >= 0 && joystick->hwdata->epoll_managed) {
+        /* Skip the read if there's nothing waiting */
+        LINUX_EpollPoll();
+        has_input = (joystick->hwdata->pending || joystick->hwdata->fresh);
+        joystick->hwdata->pending = SDL_FALSE;
+    }
+#endif
+
+    if (has_input) {
+        if (joystick->hwdata->classic) {
+            HandleClassicEvents(joystick);
+        } else {
+            HandleInputEvents(joystick);
+        }
     }
 
     /* Deliver ball motion updates */
@@ -1569,6 +1741,11 @@ LINUX_JoystickClose(SDL_Joystick *joystick)
             joystick->hwdata->effect.id = -1;
         }
         if (joystick->hwdata->fd >= 0) {
+#ifdef HAVE_SYS_EPOLL_H
+            if (joystick->hwdata->epoll_managed) {
+                LINUX_EpollRemove(joystick->hwdata->fd);
+            }
+#endif
             close(joystick->hwdata->fd);
         }
         if (joystick->hwdata->item) {
@@ -1595,6 +1772,13 @@ LINUX_JoystickQuit(void)
         inotify_fd = -1;
     }
 
+#ifdef HAVE_SYS_EPOLL_H
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
+#endif
+
     for (item = SDL_joylist; item; item = next) {
         next = item->next;
         FreeJoylistItem(item);
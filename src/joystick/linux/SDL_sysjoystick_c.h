@@ -24,6 +24,8 @@
 
 #include <linux/input.h>
 
+#include "../../core/linux/SDL_evdev_capabilities.h"
+
 struct SDL_joylist_item;
 
 /* The private structure used to keep track of a joystick */
@@ -56,6 +58,15 @@ struct joystick_hwdata
     SDL_bool has_key[KEY_MAX];
     SDL_bool has_abs[ABS_MAX];
 
+    /* Compact lists of the codes present, so resyncs don't scan every code */
+    Uint16 key_codes[KEY_MAX];
+    Uint8 abs_codes[ABS_MAX];
+    int nkey_codes;
+    int nabs_codes;
+
+    /* Button state as last reported, so resyncs only send changed buttons */
+    unsigned long key_state[NBITS(KEY_MAX)];
+
     /* Support for the classic joystick interface */
     SDL_bool classic;
     Uint16 *key_pam;
@@ -86,6 +97,12 @@ struct joystick_hwdata
 
     /* Set when gamepad is pending removal due to ENODEV read error */
     SDL_bool gone;
+
+    /* Set when the device was added to epoll, otherwise it's read on every update */
+    SDL_bool epoll_managed;
+
+    /* Set when epoll reports input waiting on the device */
+    SDL_bool pending;
 };
 
 #endif /* SDL_sysjoystick_c_h_ */
@@ -24,6 +24,8 @@
 
 /* This is the virtual implementation of the SDL joystick API */
 
+#include "SDL_events.h"
+#include "SDL_timer.h"
 #include "SDL_virtualjoystick_c.h"
 #include "../SDL_sysjoystick.h"
 #include "../SDL_joystick_c.h"
@@ -68,6 +70,10 @@ VIRTUAL_FreeHWData(joystick_hwdata *hwdata)
         SDL_free(hwdata->hats);
         hwdata->hats = NULL;
     }
+    if (hwdata->script) {
+        SDL_free(hwdata->script);
+        hwdata->script = NULL;
+    }
 
     /* Remove hwdata from SDL-global list */
     while (cur) {
@@ -238,6 +244,124 @@ SDL_JoystickSetVirtualHatInner(SDL_Joystick *joystick, int hat, Uint8 value)
 }
 
 
+int
+SDL_JoystickPlayVirtualInner(SDL_Joystick *joystick, const SDL_VirtualJoystickInput *inputs, int num_inputs, int rate, SDL_bool loop)
+{
+    joystick_hwdata *hwdata;
+    SDL_VirtualJoystickInput *script = NULL;
+    int i;
+
+    SDL_LockJoysticks();
+
+    if (!joystick || !joystick->hwdata) {
+        SDL_UnlockJoysticks();
+        return SDL_SetError("Invalid joystick");
+    }
+
+    hwdata = (joystick_hwdata *)joystick->hwdata;
+    if (inputs && num_inputs > 0) {
+        if (rate <= 0) {
+            SDL_UnlockJoysticks();
+            return SDL_SetError("Invalid playback rate");
+        }
+
+        for (i = 0; i < num_inputs; ++i) {
+            const SDL_VirtualJoystickInput *input = &inputs[i];
+            int count;
+
+            switch (input->type) {
+            case SDL_JOYAXISMOTION:
+                count = hwdata->naxes;
+                break;
+            case SDL_JOYBUTTONDOWN:
+            case SDL_JOYBUTTONUP:
+                count = hwdata->nbuttons;
+                break;
+            case SDL_JOYHATMOTION:
+                count = hwdata->nhats;
+                break;
+            default:
+                SDL_UnlockJoysticks();
+                return SDL_SetError("Invalid input type at %d", i);
+            }
+            if (input->index >= count) {
+                SDL_UnlockJoysticks();
+                return SDL_SetError("Invalid input index at %d", i);
+            }
+        }
+
+        script = (SDL_VirtualJoystickInput *)SDL_malloc(num_inputs * sizeof(*script));
+        if (!script) {
+            SDL_UnlockJoysticks();
+            return SDL_OutOfMemory();
+        }
+        SDL_memcpy(script, inputs, num_inputs * sizeof(*script));
+    } else {
+        num_inputs = 0;
+    }
+
+    SDL_free(hwdata->script);
+    hwdata->script = script;
+    hwdata->script_length = num_inputs;
+    hwdata->script_rate = rate;
+    hwdata->script_loop = loop;
+    hwdata->script_start = SDL_GetPerformanceCounter();
+    hwdata->script_played = 0;
+
+    SDL_UnlockJoysticks();
+    return 0;
+}
+
+
+static void
+VIRTUAL_PlayScript(SDL_Joystick *joystick, joystick_hwdata *hwdata)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    const Uint64 elapsed = SDL_GetPerformanceCounter() - hwdata->script_start;
+    const Uint64 rate = (Uint64)hwdata->script_rate;
+    Uint64 due;
+
+    /* Split the conversion so high resolution counters don't overflow */
+    due = (elapsed / freq) * rate + ((elapsed % freq) * rate) / freq;
+    if (!hwdata->script_loop && due > (Uint64)hwdata->script_length) {
+        due = hwdata->script_length;
+    }
+    if (due - hwdata->script_played > rate) {
+        /* We fell too far behind, skip ahead rather than flooding the app */
+        hwdata->script_played = due - rate;
+    }
+
+    while (hwdata->script_played < due) {
+        const SDL_VirtualJoystickInput *input = &hwdata->script[hwdata->script_played % hwdata->script_length];
+
+        switch (input->type) {
+        case SDL_JOYAXISMOTION:
+            hwdata->axes[input->index] = input->value;
+            SDL_PrivateJoystickAxis(joystick, input->index, input->value);
+            break;
+        case SDL_JOYBUTTONDOWN:
+        case SDL_JOYBUTTONUP:
+            hwdata->buttons[input->index] = (input->type == SDL_JOYBUTTONDOWN) ? SDL_PRESSED : SDL_RELEASED;
+            SDL_PrivateJoystickButton(joystick, input->index, hwdata->buttons[input->index]);
+            break;
+        case SDL_JOYHATMOTION:
+            hwdata->hats[input->index] = (Uint8)input->value;
+            SDL_PrivateJoystickHat(joystick, input->index, hwdata->hats[input->index]);
+            break;
+        default:
+            break;
+        }
+        ++hwdata->script_played;
+    }
+
+    if (!hwdata->script_loop && hwdata->script_played == (Uint64)hwdata->script_length) {
+        SDL_free(hwdata->script);
+        hwdata->script = NULL;
+        hwdata->script_length = 0;
+    }
+}
+
+
 static int
 VIRTUAL_JoystickInit(void)
 {
@@ -386,6 +510,10 @@ VIRTUAL_JoystickUpdate(SDL_Joystick *joystick)
 
     hwdata = (joystick_hwdata *)joystick->hwdata;
 
+    if (hwdata->script) {
+        VIRTUAL_PlayScript(joystick, hwdata);
+    }
+
     for (i = 0; i < hwdata->naxes; ++i) {
         SDL_PrivateJoystickAxis(joystick, i, hwdata->axes[i]);
     }
@@ -44,6 +44,15 @@ typedef struct joystick_hwdata
     Uint8 *hats;
     SDL_JoystickID instance_id;
     SDL_bool opened;
+
+    /* Playback script set with SDL_JoystickPlayVirtual() */
+    SDL_VirtualJoystickInput *script;
+    int script_length;
+    int script_rate;
+    SDL_bool script_loop;
+    Uint64 script_start;
+    Uint64 script_played;
+
     struct joystick_hwdata *next;
 } joystick_hwdata;
 
@@ -57,6 +66,7 @@ int SDL_JoystickDetachVirtualInner(int device_index);
 int SDL_JoystickSetVirtualAxisInner(SDL_Joystick * joystick, int axis, Sint16 value);
 int SDL_JoystickSetVirtualButtonInner(SDL_Joystick * joystick, int button, Uint8 value);
 int SDL_JoystickSetVirtualHatInner(SDL_Joystick * joystick, int hat, Uint8 value);
+int SDL_JoystickPlayVirtualInner(SDL_Joystick * joystick, const SDL_VirtualJoystickInput *inputs, int num_inputs, int rate, SDL_bool loop);
 
 #endif  /* SDL_JOYSTICK_VIRTUAL */
 #endif  /* SDL_VIRTUALJOYSTICK_C_H */
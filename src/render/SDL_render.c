@@ -27,6 +27,7 @@
 #include "SDL_sysrender.h"
 #include "software/SDL_render_sw_c.h"
 #include "../video/SDL_pixels_c.h"
+#include "../SDL_hints_c.h"
 
 #if defined(__ANDROID__)
 #  include "../core/android/SDL_android.h"
@@ -901,13 +902,7 @@ void VerifyDrawQueueFunctions(const SDL_Renderer *renderer)
 
 static SDL_RenderLineMethod SDL_GetRenderLineMethod()
 {
-    const char *hint = SDL_GetHint(SDL_HINT_RENDER_LINE_METHOD);
-
-    int method = 0;
-    if (hint) {
-        method = SDL_atoi(hint);
-    }
-    switch (method) {
+    switch (SDL_GetHintInt(SDL_HINT_RENDER_LINE_METHOD, 0)) {
     case 1:
         return SDL_RENDERLINEMETHOD_POINTS;
     case 2:
@@ -29,6 +29,7 @@
 
 #include "SDL_stdinc.h"
 #include "SDL_endian.h"
+#include "SDL_cpuinfo.h"
 
 #if defined(HAVE_ICONV) && defined(HAVE_ICONV_H)
 #ifdef __FreeBSD__
@@ -198,6 +199,348 @@ getlocale(char *buffer, size_t bufsize)
     return buffer;
 }
 
+/* Decode a UTF-8 sequence, replacing illegal sequences with UNKNOWN_UNICODE.
+   Returns the number of bytes used, or 0 if the sequence is cut off by the
+   end of the input. */
+static size_t
+UTF8_Decode(const Uint8 *p, size_t srclen, Uint32 *codepoint)
+{
+    Uint32 ch;
+    size_t left = 0;
+    size_t used = 1;
+    SDL_bool overlong = SDL_FALSE;
+
+    if (p[0] >= 0xF0) {
+        if ((p[0] & 0xF8) != 0xF0) {
+            /* Skip illegal sequences
+               return SDL_ICONV_EILSEQ;
+             */
+            ch = UNKNOWN_UNICODE;
+        } else {
+            if (p[0] == 0xF0 && srclen > 1 && (p[1] & 0xF0) == 0x80) {
+                overlong = SDL_TRUE;
+            }
+            ch = (Uint32) (p[0] & 0x07);
+            left = 3;
+        }
+    } else if (p[0] >= 0xE0) {
+        if (p[0] == 0xE0 && srclen > 1 && (p[1] & 0xE0) == 0x80) {
+            overlong = SDL_TRUE;
+        }
+        ch = (Uint32) (p[0] & 0x0F);
+        left = 2;
+    } else if (p[0] >= 0xC0) {
+        if ((p[0] & 0xDE) == 0xC0) {
+            overlong = SDL_TRUE;
+        }
+        ch = (Uint32) (p[0] & 0x1F);
+        left = 1;
+    } else {
+        if ((p[0] & 0x80) != 0x00) {
+            /* Skip illegal sequences
+               return SDL_ICONV_EILSEQ;
+             */
+            ch = UNKNOWN_UNICODE;
+        } else {
+            ch = (Uint32) p[0];
+        }
+    }
+    if (srclen - 1 < left) {
+        return 0;
+    }
+    while (left--) {
+        if ((p[used] & 0xC0) != 0x80) {
+            /* Skip illegal sequences
+               return SDL_ICONV_EILSEQ;
+             */
+            ch = UNKNOWN_UNICODE;
+            break;
+        }
+        ch <<= 6;
+        ch |= (p[used] & 0x3F);
+        ++used;
+    }
+    if (overlong) {
+        /* Potential security risk
+           return SDL_ICONV_EILSEQ;
+         */
+        ch = UNKNOWN_UNICODE;
+    }
+    if ((ch >= 0xD800 && ch <= 0xDFFF) ||
+        (ch == 0xFFFE || ch == 0xFFFF) || ch > 0x10FFFF) {
+        /* Skip illegal sequences
+           return SDL_ICONV_EILSEQ;
+         */
+        ch = UNKNOWN_UNICODE;
+    }
+    *codepoint = ch;
+    return used;
+}
+
+/* Encode a character as UTF-8, returning the number of bytes written or 0
+   if there isn't enough room */
+static size_t
+UTF8_Encode(Uint32 ch, Uint8 *p, size_t dstlen)
+{
+    if (ch > 0x10FFFF) {
+        ch = UNKNOWN_UNICODE;
+    }
+    if (ch <= 0x7F) {
+        if (dstlen < 1) {
+            return 0;
+        }
+        *p = (Uint8) ch;
+        return 1;
+    } else if (ch <= 0x7FF) {
+        if (dstlen < 2) {
+            return 0;
+        }
+        p[0] = 0xC0 | (Uint8) ((ch >> 6) & 0x1F);
+        p[1] = 0x80 | (Uint8) (ch & 0x3F);
+        return 2;
+    } else if (ch <= 0xFFFF) {
+        if (dstlen < 3) {
+            return 0;
+        }
+        p[0] = 0xE0 | (Uint8) ((ch >> 12) & 0x0F);
+        p[1] = 0x80 | (Uint8) ((ch >> 6) & 0x3F);
+        p[2] = 0x80 | (Uint8) (ch & 0x3F);
+        return 3;
+    } else {
+        if (dstlen < 4) {
+            return 0;
+        }
+        p[0] = 0xF0 | (Uint8) ((ch >> 18) & 0x07);
+        p[1] = 0x80 | (Uint8) ((ch >> 12) & 0x3F);
+        p[2] = 0x80 | (Uint8) ((ch >> 6) & 0x3F);
+        p[3] = 0x80 | (Uint8) (ch & 0x3F);
+        return 4;
+    }
+}
+
+/* Decode a UTF-16LE character, like UTF8_Decode() */
+static size_t
+UTF16LE_Decode(const Uint8 *p, size_t srclen, Uint32 *codepoint)
+{
+    Uint16 W1, W2;
+
+    if (srclen < 2) {
+        return 0;
+    }
+    W1 = ((Uint16) p[1] << 8) | (Uint16) p[0];
+    if (W1 < 0xD800 || W1 > 0xDFFF) {
+        *codepoint = (Uint32) W1;
+        return 2;
+    }
+    if (W1 > 0xDBFF) {
+        /* Skip illegal sequences
+           return SDL_ICONV_EILSEQ;
+         */
+        *codepoint = UNKNOWN_UNICODE;
+        return 2;
+    }
+    if (srclen < 4) {
+        return 0;
+    }
+    W2 = ((Uint16) p[3] << 8) | (Uint16) p[2];
+    if (W2 < 0xDC00 || W2 > 0xDFFF) {
+        /* Skip illegal sequences
+           return SDL_ICONV_EILSEQ;
+         */
+        *codepoint = UNKNOWN_UNICODE;
+        return 4;
+    }
+    *codepoint = (((Uint32) (W1 & 0x3FF) << 10) |
+                  (Uint32) (W2 & 0x3FF)) + 0x10000;
+    return 4;
+}
+
+/* Encode a character as UTF-16LE, like UTF8_Encode() */
+static size_t
+UTF16LE_Encode(Uint32 ch, Uint8 *p, size_t dstlen)
+{
+    if (ch > 0x10FFFF) {
+        ch = UNKNOWN_UNICODE;
+    }
+    if (ch < 0x10000) {
+        if (dstlen < 2) {
+            return 0;
+        }
+        p[1] = (Uint8) (ch >> 8);
+        p[0] = (Uint8) ch;
+        return 2;
+    } else {
+        Uint16 W1, W2;
+        if (dstlen < 4) {
+            return 0;
+        }
+        ch = ch - 0x10000;
+        W1 = 0xD800 | (Uint16) ((ch >> 10) & 0x3FF);
+        W2 = 0xDC00 | (Uint16) (ch & 0x3FF);
+        p[1] = (Uint8) (W1 >> 8);
+        p[0] = (Uint8) W1;
+        p[3] = (Uint8) (W2 >> 8);
+        p[2] = (Uint8) W2;
+        return 4;
+    }
+}
+
+/* The size of the characters of the little endian encodings where ASCII
+   is stored as a zero extended byte, or 0 for other encodings */
+static size_t
+ASCII_WideUnit(int format)
+{
+    switch (format) {
+    case ENCODING_UTF16LE:
+    case ENCODING_UCS2LE:
+        return 2;
+    case ENCODING_UTF32LE:
+    case ENCODING_UCS4LE:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN && defined(__ARM_NEON) && !defined(SDL_DISABLE_ARM_NEON_H)
+/* Non-zero if any lane of a comparison is set */
+static SDL_INLINE Uint64
+NEON_AnySet(uint8x16_t cmp)
+{
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0);
+}
+#endif
+
+/* Convert up to count ASCII characters from UTF-8 to a little endian
+   encoding with characters of unit bytes, stopping at the first character
+   that isn't ASCII. Returns the number of characters converted. */
+static size_t
+ASCII_Widen(const Uint8 *src, Uint8 *dst, size_t count, size_t unit)
+{
+    size_t i = 0;
+
+#if defined(__SSE2__) && !defined(SDL_DISABLE_EMMINTRIN_H)
+    const __m128i zero = _mm_setzero_si128();
+    while (count - i >= 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i lo, hi;
+        if (_mm_movemask_epi8(v)) {
+            break;
+        }
+        lo = _mm_unpacklo_epi8(v, zero);
+        hi = _mm_unpackhi_epi8(v, zero);
+        if (unit == 2) {
+            _mm_storeu_si128((__m128i *) (dst + i * 2), lo);
+            _mm_storeu_si128((__m128i *) (dst + i * 2 + 16), hi);
+        } else {
+            _mm_storeu_si128((__m128i *) (dst + i * 4), _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128((__m128i *) (dst + i * 4 + 16), _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128((__m128i *) (dst + i * 4 + 32), _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128((__m128i *) (dst + i * 4 + 48), _mm_unpackhi_epi16(hi, zero));
+        }
+        i += 16;
+    }
+#elif SDL_BYTEORDER == SDL_LIL_ENDIAN && defined(__ARM_NEON) && !defined(SDL_DISABLE_ARM_NEON_H)
+    while (count - i >= 16) {
+        const uint8x16_t v = vld1q_u8(src + i);
+        uint16x8_t lo, hi;
+        if (NEON_AnySet(vcltq_s8(vreinterpretq_s8_u8(v), vdupq_n_s8(0)))) {
+            break;
+        }
+        lo = vmovl_u8(vget_low_u8(v));
+        hi = vmovl_u8(vget_high_u8(v));
+        if (unit == 2) {
+            vst1q_u8(dst + i * 2, vreinterpretq_u8_u16(lo));
+            vst1q_u8(dst + i * 2 + 16, vreinterpretq_u8_u16(hi));
+        } else {
+            vst1q_u8(dst + i * 4, vreinterpretq_u8_u32(vmovl_u16(vget_low_u16(lo))));
+            vst1q_u8(dst + i * 4 + 16, vreinterpretq_u8_u32(vmovl_u16(vget_high_u16(lo))));
+            vst1q_u8(dst + i * 4 + 32, vreinterpretq_u8_u32(vmovl_u16(vget_low_u16(hi))));
+            vst1q_u8(dst + i * 4 + 48, vreinterpretq_u8_u32(vmovl_u16(vget_high_u16(hi))));
+        }
+        i += 16;
+    }
+#endif
+
+    while (i < count && src[i] < 0x80) {
+        Uint8 *p = dst + i * unit;
+        p[0] = src[i];
+        p[1] = 0;
+        if (unit == 4) {
+            p[2] = 0;
+            p[3] = 0;
+        }
+        ++i;
+    }
+    return i;
+}
+
+/* The reverse of ASCII_Widen() */
+static size_t
+ASCII_Narrow(const Uint8 *src, Uint8 *dst, size_t count, size_t unit)
+{
+    size_t i = 0;
+
+#if defined(__SSE2__) && !defined(SDL_DISABLE_EMMINTRIN_H)
+    const __m128i zero = _mm_setzero_si128();
+    while (count - i >= 16) {
+        if (unit == 2) {
+            const __m128i a = _mm_loadu_si128((const __m128i *) (src + i * 2));
+            const __m128i b = _mm_loadu_si128((const __m128i *) (src + i * 2 + 16));
+            const __m128i high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16((short) 0xFF80));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) {
+                break;
+            }
+            _mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(a, b));
+        } else {
+            const __m128i a = _mm_loadu_si128((const __m128i *) (src + i * 4));
+            const __m128i b = _mm_loadu_si128((const __m128i *) (src + i * 4 + 16));
+            const __m128i c = _mm_loadu_si128((const __m128i *) (src + i * 4 + 32));
+            const __m128i d = _mm_loadu_si128((const __m128i *) (src + i * 4 + 48));
+            const __m128i high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), _mm_set1_epi32((int) 0xFFFFFF80));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xFFFF) {
+                break;
+            }
+            _mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+        }
+        i += 16;
+    }
+#elif SDL_BYTEORDER == SDL_LIL_ENDIAN && defined(__ARM_NEON) && !defined(SDL_DISABLE_ARM_NEON_H)
+    while (count - i >= 16) {
+        if (unit == 2) {
+            const uint16x8_t a = vreinterpretq_u16_u8(vld1q_u8(src + i * 2));
+            const uint16x8_t b = vreinterpretq_u16_u8(vld1q_u8(src + i * 2 + 16));
+            if (NEON_AnySet(vreinterpretq_u8_u16(vtstq_u16(vorrq_u16(a, b), vdupq_n_u16(0xFF80))))) {
+                break;
+            }
+            vst1q_u8(dst + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+        } else {
+            const uint32x4_t a = vreinterpretq_u32_u8(vld1q_u8(src + i * 4));
+            const uint32x4_t b = vreinterpretq_u32_u8(vld1q_u8(src + i * 4 + 16));
+            const uint32x4_t c = vreinterpretq_u32_u8(vld1q_u8(src + i * 4 + 32));
+            const uint32x4_t d = vreinterpretq_u32_u8(vld1q_u8(src + i * 4 + 48));
+            const uint32x4_t any = vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d));
+            if (NEON_AnySet(vreinterpretq_u8_u32(vtstq_u32(any, vdupq_n_u32(0xFFFFFF80))))) {
+                break;
+            }
+            vst1q_u8(dst + i, vcombine_u8(vmovn_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b))),
+                                          vmovn_u16(vcombine_u16(vmovn_u32(c), vmovn_u32(d)))));
+        }
+        i += 16;
+    }
+#endif
+
+    while (i < count) {
+        const Uint8 *p = src + i * unit;
+        if (p[0] >= 0x80 || p[1] != 0 || (unit == 4 && (p[2] != 0 || p[3] != 0))) {
+            break;
+        }
+        dst[i] = p[0];
+        ++i;
+    }
+    return i;
+}
+
 SDL_iconv_t
 SDL_iconv_open(const char *tocode, const char *fromcode)
 {
@@ -249,6 +592,7 @@ SDL_iconv(SDL_iconv_t cd,
     size_t srclen, dstlen;
     Uint32 ch = 0;
     size_t total;
+    size_t widen = 0, narrow = 0;
 
     if (!inbuf || !*inbuf) {
         /* Reset the context */
@@ -334,8 +678,43 @@ SDL_iconv(SDL_iconv_t cd,
         break;
     }
 
+    /* Runs of ASCII can be copied straight between UTF-8 and the little
+       endian wide encodings used for wchar_t and WCHAR strings */
+    if (cd->src_fmt == ENCODING_UTF8) {
+        widen = ASCII_WideUnit(cd->dst_fmt);
+    } else if (cd->dst_fmt == ENCODING_UTF8) {
+        narrow = ASCII_WideUnit(cd->src_fmt);
+    }
+
     total = 0;
     while (srclen > 0) {
+        if (widen || narrow) {
+            size_t count;
+            if (widen) {
+                count = ASCII_Widen((const Uint8 *) src, (Uint8 *) dst, SDL_min(srclen, dstlen / widen), widen);
+                src += count;
+                srclen -= count;
+                dst += count * widen;
+                dstlen -= count * widen;
+            } else {
+                count = ASCII_Narrow((const Uint8 *) src, (Uint8 *) dst, SDL_min(srclen / narrow, dstlen), narrow);
+                src += count * narrow;
+                srclen -= count * narrow;
+                dst += count;
+                dstlen -= count;
+            }
+            if (count) {
+                *inbuf = src;
+                *inbytesleft = srclen;
+                *outbuf = dst;
+                *outbytesleft = dstlen;
+                total += count;
+                if (srclen == 0) {
+                    break;
+                }
+            }
+        }
+
         /* Decode a character */
         switch (cd->src_fmt) {
         case ENCODING_ASCII:
@@ -356,90 +735,12 @@ SDL_iconv(SDL_iconv_t cd,
             break;
         case ENCODING_UTF8:    /* RFC 3629 */
             {
-                Uint8 *p = (Uint8 *) src;
-                size_t left = 0;
-                SDL_bool overlong = SDL_FALSE;
-                if (p[0] >= 0xF0) {
-                    if ((p[0] & 0xF8) != 0xF0) {
-                        /* Skip illegal sequences
-                           return SDL_ICONV_EILSEQ;
-                         */
-                        ch = UNKNOWN_UNICODE;
-                    } else {
-                        if (p[0] == 0xF0 && srclen > 1 && (p[1] & 0xF0) == 0x80) {
-                            overlong = SDL_TRUE;
-                        }
-                        ch = (Uint32) (p[0] & 0x07);
-                        left = 3;
-                    }
-                } else if (p[0] >= 0xE0) {
-                    if ((p[0] & 0xF0) != 0xE0) {
-                        /* Skip illegal sequences
-                           return SDL_ICONV_EILSEQ;
-                         */
-                        ch = UNKNOWN_UNICODE;
-                    } else {
-                        if (p[0] == 0xE0 && srclen > 1 && (p[1] & 0xE0) == 0x80) {
-                            overlong = SDL_TRUE;
-                        }
-                        ch = (Uint32) (p[0] & 0x0F);
-                        left = 2;
-                    }
-                } else if (p[0] >= 0xC0) {
-                    if ((p[0] & 0xE0) != 0xC0) {
-                        /* Skip illegal sequences
-                           return SDL_ICONV_EILSEQ;
-                         */
-                        ch = UNKNOWN_UNICODE;
-                    } else {
-                        if ((p[0] & 0xDE) == 0xC0) {
-                            overlong = SDL_TRUE;
-                        }
-                        ch = (Uint32) (p[0] & 0x1F);
-                        left = 1;
-                    }
-                } else {
-                    if ((p[0] & 0x80) != 0x00) {
-                        /* Skip illegal sequences
-                           return SDL_ICONV_EILSEQ;
-                         */
-                        ch = UNKNOWN_UNICODE;
-                    } else {
-                        ch = (Uint32) p[0];
-                    }
-                }
-                ++src;
-                --srclen;
-                if (srclen < left) {
+                size_t used = UTF8_Decode((const Uint8 *) src, srclen, &ch);
+                if (!used) {
                     return SDL_ICONV_EINVAL;
                 }
-                while (left--) {
-                    ++p;
-                    if ((p[0] & 0xC0) != 0x80) {
-                        /* Skip illegal sequences
-                           return SDL_ICONV_EILSEQ;
-                         */
-                        ch = UNKNOWN_UNICODE;
-                        break;
-                    }
-                    ch <<= 6;
-                    ch |= (p[0] & 0x3F);
-                    ++src;
-                    --srclen;
-                }
-                if (overlong) {
-                    /* Potential security risk
-                       return SDL_ICONV_EILSEQ;
-                     */
-                    ch = UNKNOWN_UNICODE;
-                }
-                if ((ch >= 0xD800 && ch <= 0xDFFF) ||
-                    (ch == 0xFFFE || ch == 0xFFFF) || ch > 0x10FFFF) {
-                    /* Skip illegal sequences
-                       return SDL_ICONV_EILSEQ;
-                     */
-                    ch = UNKNOWN_UNICODE;
-                }
+                src += used;
+                srclen -= used;
             }
             break;
         case ENCODING_UTF16BE: /* RFC 2781 */
@@ -483,41 +784,12 @@ SDL_iconv(SDL_iconv_t cd,
             break;
         case ENCODING_UTF16LE: /* RFC 2781 */
             {
-                Uint8 *p = (Uint8 *) src;
-                Uint16 W1, W2;
-                if (srclen < 2) {
-                    return SDL_ICONV_EINVAL;
-                }
-                W1 = ((Uint16) p[1] << 8) | (Uint16) p[0];
-                src += 2;
-                srclen -= 2;
-                if (W1 < 0xD800 || W1 > 0xDFFF) {
-                    ch = (Uint32) W1;
-                    break;
-                }
-                if (W1 > 0xDBFF) {
-                    /* Skip illegal sequences
-                       return SDL_ICONV_EILSEQ;
-                     */
-                    ch = UNKNOWN_UNICODE;
-                    break;
-                }
-                if (srclen < 2) {
+                size_t used = UTF16LE_Decode((const Uint8 *) src, srclen, &ch);
+                if (!used) {
                     return SDL_ICONV_EINVAL;
                 }
-                p = (Uint8 *) src;
-                W2 = ((Uint16) p[1] << 8) | (Uint16) p[0];
-                src += 2;
-                srclen -= 2;
-                if (W2 < 0xDC00 || W2 > 0xDFFF) {
-                    /* Skip illegal sequences
-                       return SDL_ICONV_EILSEQ;
-                     */
-                    ch = UNKNOWN_UNICODE;
-                    break;
-                }
-                ch = (((Uint32) (W1 & 0x3FF) << 10) |
-                      (Uint32) (W2 & 0x3FF)) + 0x10000;
+                src += used;
+                srclen -= used;
             }
             break;
         case ENCODING_UCS2LE:
@@ -606,45 +878,12 @@ SDL_iconv(SDL_iconv_t cd,
             break;
         case ENCODING_UTF8:    /* RFC 3629 */
             {
-                Uint8 *p = (Uint8 *) dst;
-                if (ch > 0x10FFFF) {
-                    ch = UNKNOWN_UNICODE;
-                }
-                if (ch <= 0x7F) {
-                    if (dstlen < 1) {
-                        return SDL_ICONV_E2BIG;
-                    }
-                    *p = (Uint8) ch;
-                    ++dst;
-                    --dstlen;
-                } else if (ch <= 0x7FF) {
-                    if (dstlen < 2) {
-                        return SDL_ICONV_E2BIG;
-                    }
-                    p[0] = 0xC0 | (Uint8) ((ch >> 6) & 0x1F);
-                    p[1] = 0x80 | (Uint8) (ch & 0x3F);
-                    dst += 2;
-                    dstlen -= 2;
-                } else if (ch <= 0xFFFF) {
-                    if (dstlen < 3) {
-                        return SDL_ICONV_E2BIG;
-                    }
-                    p[0] = 0xE0 | (Uint8) ((ch >> 12) & 0x0F);
-                    p[1] = 0x80 | (Uint8) ((ch >> 6) & 0x3F);
-                    p[2] = 0x80 | (Uint8) (ch & 0x3F);
-                    dst += 3;
-                    dstlen -= 3;
-                } else {
-                    if (dstlen < 4) {
-                        return SDL_ICONV_E2BIG;
-                    }
-                    p[0] = 0xF0 | (Uint8) ((ch >> 18) & 0x07);
-                    p[1] = 0x80 | (Uint8) ((ch >> 12) & 0x3F);
-                    p[2] = 0x80 | (Uint8) ((ch >> 6) & 0x3F);
-                    p[3] = 0x80 | (Uint8) (ch & 0x3F);
-                    dst += 4;
-                    dstlen -= 4;
+                size_t used = UTF8_Encode(ch, (Uint8 *) dst, dstlen);
+                if (!used) {
+                    return SDL_ICONV_E2BIG;
                 }
+                dst += used;
+                dstlen -= used;
             }
             break;
         case ENCODING_UTF16BE: /* RFC 2781 */
@@ -680,33 +919,12 @@ SDL_iconv(SDL_iconv_t cd,
             break;
         case ENCODING_UTF16LE: /* RFC 2781 */
             {
-                Uint8 *p = (Uint8 *) dst;
-                if (ch > 0x10FFFF) {
-                    ch = UNKNOWN_UNICODE;
-                }
-                if (ch < 0x10000) {
-                    if (dstlen < 2) {
-                        return SDL_ICONV_E2BIG;
-                    }
-                    p[1] = (Uint8) (ch >> 8);
-                    p[0] = (Uint8) ch;
-                    dst += 2;
-                    dstlen -= 2;
-                } else {
-                    Uint16 W1, W2;
-                    if (dstlen < 4) {
-                        return SDL_ICONV_E2BIG;
-                    }
-                    ch = ch - 0x10000;
-                    W1 = 0xD800 | (Uint16) ((ch >> 10) & 0x3FF);
-                    W2 = 0xDC00 | (Uint16) (ch & 0x3FF);
-                    p[1] = (Uint8) (W1 >> 8);
-                    p[0] = (Uint8) W1;
-                    p[3] = (Uint8) (W2 >> 8);
-                    p[2] = (Uint8) W2;
-                    dst += 4;
-                    dstlen -= 4;
+                size_t used = UTF16LE_Encode(ch, (Uint8 *) dst, dstlen);
+                if (!used) {
+                    return SDL_ICONV_E2BIG;
                 }
+                dst += used;
+                dstlen -= used;
             }
             break;
         case ENCODING_UCS2BE:
@@ -29,6 +29,26 @@
 #include "SDL_stdinc.h"
 #include "SDL_atomic.h"
 #include "SDL_error.h"
+#include "SDL_bits.h"
+#include "SDL_thread.h"
+
+#if SDL_MEMORY_STATS && !defined(__clang_analyzer__)
+/* This file defines the functions that SDL_internal.h tags call sites for */
+#undef SDL_malloc
+#undef SDL_calloc
+#undef SDL_realloc
+#if SDL_DYNAMIC_API
+#define SDL_malloc SDL_malloc_REAL
+#define SDL_calloc SDL_calloc_REAL
+#define SDL_realloc SDL_realloc_REAL
+#endif
+#endif
+
+/* The number of mspaces the bundled allocator spreads threads over, so that
+   threads don't all contend for one lock. Set it to 0 to use a single heap. */
+#ifndef SDL_MALLOC_ARENA_BITS
+#define SDL_MALLOC_ARENA_BITS 3
+#endif
 
 #ifndef HAVE_MALLOC
 #define LACKS_SYS_TYPES_H
@@ -36,9 +56,15 @@
 #define LACKS_STRINGS_H
 #define LACKS_STRING_H
 #define LACKS_STDLIB_H
+#define LACKS_TIME_H
 #define ABORT
 #define USE_LOCKS 1
 #define USE_DL_PREFIX
+#if SDL_MALLOC_ARENA_BITS
+/* Footers let free() and realloc() find the mspace that owns a chunk */
+#define MSPACES 1
+#define FOOTERS 1
+#endif
 
 /*
   This is a version (aka dlmalloc) of malloc/free/realloc written by
@@ -1212,7 +1238,7 @@ extern "C"
 #ifndef LACKS_ERRNO_H
 #include <errno.h>              /* for MALLOC_FAILURE_ACTION */
 #endif /* LACKS_ERRNO_H */
-#if FOOTERS
+#if FOOTERS && !defined(LACKS_TIME_H)
 #include <time.h>               /* for magic initialization */
 #endif /* FOOTERS */
 #ifndef LACKS_STDLIB_H
@@ -2569,7 +2595,11 @@ init_mparams(void)
                 close(fd);
             } else
 #endif /* USE_DEV_RANDOM */
+#ifdef LACKS_TIME_H
+                s = (size_t) ((size_t) &mparams ^ (size_t) 0x55555555U);
+#else
                 s = (size_t) (time(0) ^ (size_t) 0x55555555U);
+#endif
 
             s |= (size_t) 8U;   /* ensure nonzero */
             s &= ~(size_t) 7U;  /* improve chances of fault for bad values */
@@ -3260,7 +3290,7 @@ internal_malloc_stats(mstate m)
 #else /* ONLY_MSPACES */
 #if MSPACES
 #define internal_malloc(m, b)\
-   (m == gm)? dlmalloc(b) : mspace_malloc(m, b)
+   ((m == gm)? dlmalloc(b) : mspace_malloc(m, b))
 #define internal_free(m, mem)\
    if (m == gm) dlfree(mem); else mspace_free(m,mem);
 #else /* MSPACES */
@@ -5302,6 +5332,52 @@ History:
 
 */
 
+#if SDL_MALLOC_ARENA_BITS
+#define SDL_MALLOC_ARENAS (1 << SDL_MALLOC_ARENA_BITS)
+
+static void *SDL_malloc_arenas[SDL_MALLOC_ARENAS];
+
+/* Pick an mspace for the calling thread, creating it on first use.
+   Returns NULL if it can't be created, and the main heap is used instead. */
+static mspace SDL_GetMallocArena(void)
+{
+    const Uint64 id = (Uint64)SDL_ThreadID();
+    const Uint32 hash = ((Uint32)id ^ (Uint32)(id >> 32)) * 0x9E3779B1u;
+    void **slot = &SDL_malloc_arenas[hash >> (32 - SDL_MALLOC_ARENA_BITS)];
+    mspace arena = SDL_AtomicGetPtr(slot);
+
+    if (!arena) {
+        arena = create_mspace(0, 1);
+        if (!arena) {
+            return NULL;
+        }
+        if (!SDL_AtomicCASPtr(slot, NULL, arena)) {
+            destroy_mspace(arena);
+            arena = SDL_AtomicGetPtr(slot);
+        }
+    }
+    return arena;
+}
+
+static void *SDL_arena_malloc(size_t size)
+{
+    mspace arena = SDL_GetMallocArena();
+    return arena ? mspace_malloc(arena, size) : dlmalloc(size);
+}
+
+static void *SDL_arena_calloc(size_t nmemb, size_t size)
+{
+    mspace arena = SDL_GetMallocArena();
+    return arena ? mspace_calloc(arena, nmemb, size) : dlcalloc(nmemb, size);
+}
+
+static void *SDL_arena_realloc(void *ptr, size_t size)
+{
+    /* Existing chunks are resized in the mspace that owns them */
+    return ptr ? dlrealloc(ptr, size) : SDL_arena_malloc(size);
+}
+#endif /* SDL_MALLOC_ARENA_BITS */
+
 #endif /* !HAVE_MALLOC */
 
 #ifdef HAVE_MALLOC
@@ -5309,6 +5385,11 @@ History:
 #define real_calloc calloc
 #define real_realloc realloc
 #define real_free free
+#elif SDL_MALLOC_ARENA_BITS
+#define real_malloc SDL_arena_malloc
+#define real_calloc SDL_arena_calloc
+#define real_realloc SDL_arena_realloc
+#define real_free dlfree
 #else
 #define real_malloc dlmalloc
 #define real_calloc dlcalloc
@@ -5377,6 +5458,455 @@ int SDL_GetNumAllocations(void)
     return SDL_AtomicGet(&s_mem.num_allocations);
 }
 
+#if SDL_MEMORY_STATS
+
+/* Every allocation starts with its size and tag, padded to keep the
+   alignment of the underlying allocator */
+typedef union
+{
+    struct
+    {
+        size_t size;
+        SDL_MemoryTag tag;
+    } info;
+    double align[2];
+} SDL_MemoryHeader;
+
+/* Call sites are hashed by file and line, in open addressing */
+#define SDL_MEMORY_SITES        1024
+#define SDL_MEMORY_SITE_PROBES  32
+
+/* Counters that only grow are spread over stripes picked by thread, like the
+   allocator's arenas, so threads mostly update their own cache lines */
+#define SDL_MEMORY_STAT_STRIPE_BITS 3
+#define SDL_MEMORY_STAT_STRIPES     (1 << SDL_MEMORY_STAT_STRIPE_BITS)
+
+typedef struct
+{
+    Uint64 allocations[SDL_NUM_MEMORY_TAGS];
+    Uint64 frees[SDL_NUM_MEMORY_TAGS];
+    Uint64 bytes_allocated[SDL_NUM_MEMORY_TAGS];
+    Uint64 histogram[SDL_MEMORY_HISTOGRAM_BUCKETS];
+    Uint8 padding[64];
+} SDL_MemoryStatStripe;
+
+/* All counters are atomic, only adding a call site to the table is locked.
+   s_stats holds the bytes in use and the peaks, which need a single total. */
+static SDL_SpinLock s_sites_lock;
+static SDL_MemoryStats s_stats;
+static SDL_MemoryStatStripe s_stat_stripes[SDL_MEMORY_STAT_STRIPES];
+static SDL_MemorySiteStats s_sites[SDL_MEMORY_SITES];
+
+#if defined(__GCC_ATOMIC_LLONG_LOCK_FREE) && (__GCC_ATOMIC_LLONG_LOCK_FREE == 2)
+static SDL_INLINE Uint64 StatGet(Uint64 *counter)
+{
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+static SDL_INLINE Uint64 StatAdd(Uint64 *counter, Uint64 value)
+{
+    return __atomic_add_fetch(counter, value, __ATOMIC_RELAXED);
+}
+
+static SDL_INLINE SDL_bool StatCAS(Uint64 *counter, Uint64 oldval, Uint64 newval)
+{
+    return __atomic_compare_exchange_n(counter, &oldval, newval, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED) ? SDL_TRUE : SDL_FALSE;
+}
+#elif defined(_MSC_VER) && (_MSC_VER >= 1500)
+#include <intrin.h>
+
+static SDL_INLINE Uint64 StatGet(Uint64 *counter)
+{
+    return (Uint64)_InterlockedCompareExchange64((volatile __int64 *)counter, 0, 0);
+}
+
+static SDL_INLINE SDL_bool StatCAS(Uint64 *counter, Uint64 oldval, Uint64 newval)
+{
+    return ((Uint64)_InterlockedCompareExchange64((volatile __int64 *)counter, (__int64)newval, (__int64)oldval) == oldval) ? SDL_TRUE : SDL_FALSE;
+}
+
+static SDL_INLINE Uint64 StatAdd(Uint64 *counter, Uint64 value)
+{
+    Uint64 oldval;
+    do {
+        oldval = StatGet(counter);
+    } while (!StatCAS(counter, oldval, oldval + value));
+    return oldval + value;
+}
+#else
+/* No 64-bit atomics, use a spinlock picked by the counter's address */
+static SDL_SpinLock s_stat_locks[32];
+#define STAT_LOCK(counter)  &s_stat_locks[((uintptr_t)(counter) >> 3) & 0x1f]
+
+static Uint64 StatGet(Uint64 *counter)
+{
+    Uint64 value;
+    SDL_AtomicLock(STAT_LOCK(counter));
+    value = *counter;
+    SDL_AtomicUnlock(STAT_LOCK(counter));
+    return value;
+}
+
+static Uint64 StatAdd(Uint64 *counter, Uint64 value)
+{
+    SDL_AtomicLock(STAT_LOCK(counter));
+    value = (*counter += value);
+    SDL_AtomicUnlock(STAT_LOCK(counter));
+    return value;
+}
+
+static SDL_bool StatCAS(Uint64 *counter, Uint64 oldval, Uint64 newval)
+{
+    SDL_bool retval = SDL_FALSE;
+    SDL_AtomicLock(STAT_LOCK(counter));
+    if (*counter == oldval) {
+        *counter = newval;
+        retval = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(STAT_LOCK(counter));
+    return retval;
+}
+#endif
+
+static void StatSet(Uint64 *counter, Uint64 value)
+{
+    Uint64 oldval;
+    do {
+        oldval = StatGet(counter);
+    } while (!StatCAS(counter, oldval, value));
+}
+
+static void StatMax(Uint64 *peak, Uint64 value)
+{
+    Uint64 oldval = StatGet(peak);
+    while (value > oldval && !StatCAS(peak, oldval, value)) {
+        oldval = StatGet(peak);
+    }
+}
+
+static SDL_MemoryStatStripe *GetStatStripe(void)
+{
+    const Uint64 id = (Uint64)SDL_ThreadID();
+    const Uint32 hash = ((Uint32)id ^ (Uint32)(id >> 32)) * 0x9E3779B1u;
+    return &s_stat_stripes[hash >> (32 - SDL_MEMORY_STAT_STRIPE_BITS)];
+}
+
+/* Subsystems by their directory under src/ */
+static const struct
+{
+    const char *dir;
+    SDL_MemoryTag tag;
+} s_memory_dirs[] = {
+    { "events", SDL_MEMORY_TAG_EVENTS },
+    { "audio", SDL_MEMORY_TAG_AUDIO },
+    { "render", SDL_MEMORY_TAG_RENDER },
+    { "video", SDL_MEMORY_TAG_VIDEO },
+    { "joystick", SDL_MEMORY_TAG_JOYSTICK },
+    { "hidapi", SDL_MEMORY_TAG_JOYSTICK }
+};
+
+#define IS_PATH_SEPARATOR(c)    ((c) == '/' || (c) == '\\')
+
+static SDL_MemoryTag GetMemoryTagForFile(const char *file)
+{
+    const char *dir = NULL;
+    const char *p;
+    int i;
+
+    /* Use the last src/ in the path, in case SDL is built under a src/ */
+    for (p = file; *p; ++p) {
+        if ((p == file || IS_PATH_SEPARATOR(p[-1])) &&
+            SDL_strncmp(p, "src", 3) == 0 && IS_PATH_SEPARATOR(p[3])) {
+            dir = p + 4;
+        }
+    }
+    if (dir) {
+        for (i = 0; i < SDL_arraysize(s_memory_dirs); ++i) {
+            const size_t len = SDL_strlen(s_memory_dirs[i].dir);
+            if (SDL_strncmp(dir, s_memory_dirs[i].dir, len) == 0 && IS_PATH_SEPARATOR(dir[len])) {
+                return s_memory_dirs[i].tag;
+            }
+        }
+    }
+    return SDL_MEMORY_TAG_OTHER;
+}
+
+/* Find or add the site for a call. Sites are only ever added, and a site's
+   file is published last, so lookups don't need the lock. */
+static SDL_MemorySiteStats *GetMemorySite(const char *file, int line)
+{
+    const Uint32 hash = ((Uint32)(uintptr_t)file ^ ((Uint32)line * 0x9E3779B1u)) * 0x85EBCA6Bu;
+    int i;
+
+    for (i = 0; i < SDL_MEMORY_SITE_PROBES; ++i) {
+        SDL_MemorySiteStats *site = &s_sites[((hash >> 22) + i) % SDL_MEMORY_SITES];
+        const char *site_file = (const char *)SDL_AtomicGetPtr((void **)&site->file);
+
+        if (!site_file) {
+            SDL_AtomicLock(&s_sites_lock);
+            site_file = site->file;
+            if (!site_file) {
+                site->line = line;
+                site->tag = GetMemoryTagForFile(file);
+                SDL_MemoryBarrierRelease();
+                SDL_AtomicSetPtr((void **)&site->file, (void *)file);
+                site_file = file;
+            }
+            SDL_AtomicUnlock(&s_sites_lock);
+        }
+        if (site_file == file) {
+            SDL_MemoryBarrierAcquire();
+            if (site->line == line) {
+                return site;
+            }
+        }
+    }
+    return NULL;
+}
+
+static int GetHistogramBucket(size_t size)
+{
+    int bucket;
+
+    if (size <= 16) {
+        return 0;
+    }
+    if (size > ((size_t)16 << (SDL_MEMORY_HISTOGRAM_BUCKETS - 2))) {
+        return SDL_MEMORY_HISTOGRAM_BUCKETS - 1;
+    }
+    bucket = SDL_MostSignificantBitIndex32((Uint32)(size - 1)) - 3;
+    return bucket;
+}
+
+static SDL_MemoryTag RecordAllocation(size_t size, const char *file, int line)
+{
+    SDL_MemoryTag tag = SDL_MEMORY_TAG_APPLICATION;
+    SDL_MemoryStatStripe *stripe = GetStatStripe();
+    SDL_MemoryTagStats *stats;
+
+    if (file) {
+        SDL_MemorySiteStats *site = GetMemorySite(file, line);
+        if (site) {
+            tag = site->tag;
+            StatAdd(&site->allocations, 1);
+            StatAdd(&site->bytes_allocated, size);
+        } else {
+            tag = GetMemoryTagForFile(file);
+        }
+    }
+
+    StatAdd(&stripe->allocations[tag], 1);
+    StatAdd(&stripe->bytes_allocated[tag], size);
+    StatAdd(&stripe->histogram[GetHistogramBucket(size)], 1);
+
+    stats = &s_stats.tags[tag];
+    StatMax(&stats->peak_bytes_in_use, StatAdd(&stats->bytes_in_use, size));
+    StatMax(&s_stats.peak_bytes_in_use, StatAdd(&s_stats.bytes_in_use, size));
+
+    return tag;
+}
+
+static void RecordFree(const SDL_MemoryHeader *header)
+{
+    SDL_MemoryTagStats *stats = &s_stats.tags[header->info.tag];
+    const Uint64 size = header->info.size;
+
+    StatAdd(&GetStatStripe()->frees[header->info.tag], 1);
+    StatAdd(&stats->bytes_in_use, 0 - size);
+    StatAdd(&s_stats.bytes_in_use, 0 - size);
+}
+
+void *SDL_TaggedMalloc(size_t size, const char *file, int line)
+{
+    SDL_MemoryHeader *header;
+
+    if (!size) {
+        size = 1;
+    }
+    if (size > (~(size_t)0) - sizeof(*header)) {
+        return NULL;
+    }
+
+    header = (SDL_MemoryHeader *)s_mem.malloc_func(sizeof(*header) + size);
+    if (!header) {
+        return NULL;
+    }
+    header->info.size = size;
+    header->info.tag = RecordAllocation(size, file, line);
+    SDL_AtomicIncRef(&s_mem.num_allocations);
+    return header + 1;
+}
+
+void *SDL_TaggedCalloc(size_t nmemb, size_t size, const char *file, int line)
+{
+    SDL_MemoryHeader *header;
+
+    if (!nmemb || !size) {
+        nmemb = 1;
+        size = 1;
+    }
+    if (size > ((~(size_t)0) - sizeof(*header)) / nmemb) {
+        return NULL;
+    }
+    size *= nmemb;
+
+    header = (SDL_MemoryHeader *)s_mem.calloc_func(1, sizeof(*header) + size);
+    if (!header) {
+        return NULL;
+    }
+    header->info.size = size;
+    header->info.tag = RecordAllocation(size, file, line);
+    SDL_AtomicIncRef(&s_mem.num_allocations);
+    return header + 1;
+}
+
+void *SDL_TaggedRealloc(void *ptr, size_t size, const char *file, int line)
+{
+    SDL_MemoryHeader *header;
+    SDL_MemoryHeader old;
+
+    if (!ptr) {
+        return SDL_TaggedMalloc(size, file, line);
+    }
+    if (size > (~(size_t)0) - sizeof(*header)) {
+        return NULL;
+    }
+
+    header = (SDL_MemoryHeader *)ptr - 1;
+    old = *header;
+    header = (SDL_MemoryHeader *)s_mem.realloc_func(header, sizeof(*header) + size);
+    if (!header) {
+        return NULL;
+    }
+    RecordFree(&old);
+    header->info.size = size;
+    header->info.tag = RecordAllocation(size, file, line);
+    return header + 1;
+}
+
+void *SDL_malloc(size_t size)
+{
+    return SDL_TaggedMalloc(size, NULL, 0);
+}
+
+void *SDL_calloc(size_t nmemb, size_t size)
+{
+    return SDL_TaggedCalloc(nmemb, size, NULL, 0);
+}
+
+void *SDL_realloc(void *ptr, size_t size)
+{
+    return SDL_TaggedRealloc(ptr, size, NULL, 0);
+}
+
+void SDL_free(void *ptr)
+{
+    SDL_MemoryHeader *header;
+
+    if (!ptr) {
+        return;
+    }
+
+    header = (SDL_MemoryHeader *)ptr - 1;
+    RecordFree(header);
+    s_mem.free_func(header);
+    (void)SDL_AtomicDecRef(&s_mem.num_allocations);
+}
+
+int SDL_GetMemoryStats(SDL_MemoryStats *stats)
+{
+    int i, j;
+
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    /* Each counter is read atomically, allocations in progress may be
+       partly counted */
+    SDL_zerop(stats);
+    for (i = 0; i < SDL_NUM_MEMORY_TAGS; ++i) {
+        stats->tags[i].bytes_in_use = StatGet(&s_stats.tags[i].bytes_in_use);
+        stats->tags[i].peak_bytes_in_use = StatGet(&s_stats.tags[i].peak_bytes_in_use);
+    }
+    stats->bytes_in_use = StatGet(&s_stats.bytes_in_use);
+    stats->peak_bytes_in_use = StatGet(&s_stats.peak_bytes_in_use);
+
+    for (i = 0; i < SDL_MEMORY_STAT_STRIPES; ++i) {
+        SDL_MemoryStatStripe *stripe = &s_stat_stripes[i];
+        for (j = 0; j < SDL_NUM_MEMORY_TAGS; ++j) {
+            stats->tags[j].allocations += StatGet(&stripe->allocations[j]);
+            stats->tags[j].frees += StatGet(&stripe->frees[j]);
+            stats->tags[j].bytes_allocated += StatGet(&stripe->bytes_allocated[j]);
+        }
+        for (j = 0; j < SDL_MEMORY_HISTOGRAM_BUCKETS; ++j) {
+            stats->histogram[j] += StatGet(&stripe->histogram[j]);
+        }
+    }
+    return 0;
+}
+
+int SDL_GetMemorySites(SDL_MemorySiteStats *sites, int max_sites)
+{
+    int i, j, count = 0;
+
+    if (!sites) {
+        return SDL_InvalidParamError("sites");
+    }
+
+    /* Keep the busiest sites in order, this doesn't allocate */
+    SDL_AtomicLock(&s_sites_lock);
+    for (i = 0; i < SDL_MEMORY_SITES; ++i) {
+        SDL_MemorySiteStats site = s_sites[i];
+        site.allocations = StatGet(&s_sites[i].allocations);
+        site.bytes_allocated = StatGet(&s_sites[i].bytes_allocated);
+        if (!site.allocations) {
+            continue;
+        }
+        for (j = count; j > 0 && sites[j - 1].allocations < site.allocations; --j) {
+            if (j < max_sites) {
+                sites[j] = sites[j - 1];
+            }
+        }
+        if (j < max_sites) {
+            sites[j] = site;
+            if (count < max_sites) {
+                ++count;
+            }
+        }
+    }
+    SDL_AtomicUnlock(&s_sites_lock);
+
+    return count;
+}
+
+void SDL_ResetMemoryStats(void)
+{
+    int i, j;
+
+    for (i = 0; i < SDL_NUM_MEMORY_TAGS; ++i) {
+        SDL_MemoryTagStats *stats = &s_stats.tags[i];
+        StatSet(&stats->peak_bytes_in_use, StatGet(&stats->bytes_in_use));
+    }
+    StatSet(&s_stats.peak_bytes_in_use, StatGet(&s_stats.bytes_in_use));
+    for (i = 0; i < SDL_MEMORY_STAT_STRIPES; ++i) {
+        SDL_MemoryStatStripe *stripe = &s_stat_stripes[i];
+        for (j = 0; j < SDL_NUM_MEMORY_TAGS; ++j) {
+            StatSet(&stripe->allocations[j], 0);
+            StatSet(&stripe->frees[j], 0);
+            StatSet(&stripe->bytes_allocated[j], 0);
+        }
+        for (j = 0; j < SDL_MEMORY_HISTOGRAM_BUCKETS; ++j) {
+            StatSet(&stripe->histogram[j], 0);
+        }
+    }
+    for (i = 0; i < SDL_MEMORY_SITES; ++i) {
+        StatSet(&s_sites[i].allocations, 0);
+        StatSet(&s_sites[i].bytes_allocated, 0);
+    }
+}
+
+#else
+
 void *SDL_malloc(size_t size)
 {
     void *mem;
@@ -5433,4 +5963,20 @@ void SDL_free(void *ptr)
     (void)SDL_AtomicDecRef(&s_mem.num_allocations);
 }
 
+int SDL_GetMemoryStats(SDL_MemoryStats *stats)
+{
+    return SDL_Unsupported();
+}
+
+int SDL_GetMemorySites(SDL_MemorySiteStats *sites, int max_sites)
+{
+    return SDL_Unsupported();
+}
+
+void SDL_ResetMemoryStats(void)
+{
+}
+
+#endif /* SDL_MEMORY_STATS */
+
 /* vi: set ts=4 sw=4 expandtab: */
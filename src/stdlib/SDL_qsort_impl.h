@@ -0,0 +1,314 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* This file is included by SDL_qsort.c once for each element type, with
+   these defined:
+
+   SORT_NAME(x)             - prefixes x with a name unique to the type
+   SORT_CONTEXT             - the type passed to every comparison and swap
+   SORT_LESS(ctx, a, b)     - whether element a sorts before element b
+   SORT_SWAP(ctx, a, b)     - exchanges elements a and b
+
+   Elements are referred to by index. This is Orson Peters' pattern-defeating
+   quicksort: median of three (or ninther) pivots, insertion sort for small
+   ranges, a partial insertion sort when a partition was already in order,
+   shuffling a few elements after badly unbalanced partitions, and heapsort
+   once there have been too many of those.
+
+   Unlike the original, every scan is bounds checked, so a comparison
+   function that isn't a strict weak ordering gives a wrong order rather than
+   reading outside the array.
+*/
+
+static void
+SORT_NAME(insertion_sort)(SORT_CONTEXT ctx, size_t begin, size_t end)
+{
+    size_t i, j;
+
+    for (i = begin + 1; i < end; ++i) {
+        for (j = i; j > begin && SORT_LESS(ctx, j, j - 1); --j) {
+            SORT_SWAP(ctx, j, j - 1);
+        }
+    }
+}
+
+/* Insertion sort that gives up after moving a few elements */
+static SDL_bool
+SORT_NAME(partial_insertion_sort)(SORT_CONTEXT ctx, size_t begin, size_t end)
+{
+    size_t moves = 0;
+    size_t i, j;
+
+    for (i = begin + 1; i < end; ++i) {
+        for (j = i; j > begin && SORT_LESS(ctx, j, j - 1); --j) {
+            SORT_SWAP(ctx, j, j - 1);
+            ++moves;
+        }
+        if (moves > SORT_PARTIAL_INSERTION_LIMIT) {
+            return SDL_FALSE;
+        }
+    }
+    return SDL_TRUE;
+}
+
+static void
+SORT_NAME(sort3)(SORT_CONTEXT ctx, size_t a, size_t b, size_t c)
+{
+    if (SORT_LESS(ctx, b, a)) {
+        SORT_SWAP(ctx, a, b);
+    }
+    if (SORT_LESS(ctx, c, b)) {
+        SORT_SWAP(ctx, b, c);
+        if (SORT_LESS(ctx, b, a)) {
+            SORT_SWAP(ctx, a, b);
+        }
+    }
+}
+
+static void
+SORT_NAME(sift_down)(SORT_CONTEXT ctx, size_t begin, size_t root, size_t count)
+{
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && SORT_LESS(ctx, begin + child, begin + child + 1)) {
+            ++child;
+        }
+        if (!SORT_LESS(ctx, begin + root, begin + child)) {
+            break;
+        }
+        SORT_SWAP(ctx, begin + root, begin + child);
+        root = child;
+    }
+}
+
+static void
+SORT_NAME(heapsort)(SORT_CONTEXT ctx, size_t begin, size_t end)
+{
+    const size_t count = end - begin;
+    size_t i;
+
+    for (i = count / 2; i-- > 0; ) {
+        SORT_NAME(sift_down)(ctx, begin, i, count);
+    }
+    for (i = count - 1; i > 0; --i) {
+        SORT_SWAP(ctx, begin, begin + i);
+        SORT_NAME(sift_down)(ctx, begin, 0, i);
+    }
+}
+
+/* Partition around the pivot at begin, with elements equal to the pivot
+   going right. Returns the final position of the pivot. */
+static size_t
+SORT_NAME(partition_right)(SORT_CONTEXT ctx, size_t begin, size_t end, SDL_bool *already_partitioned)
+{
+    size_t first = begin;
+    size_t last = end;
+    size_t pivot_pos;
+
+    /* Find the first element not less than the pivot */
+    do {
+        ++first;
+    } while (first < end && SORT_LESS(ctx, first, begin));
+
+    /* Find the last element less than the pivot */
+    if (first - 1 == begin) {
+        while (first < last) {
+            --last;
+            if (SORT_LESS(ctx, last, begin)) {
+                break;
+            }
+        }
+    } else {
+        do {
+            --last;
+        } while (last > begin + 1 && !SORT_LESS(ctx, last, begin));
+    }
+
+    /* If these already crossed there is nothing to swap */
+    *already_partitioned = (first >= last);
+
+    while (first < last) {
+        SORT_SWAP(ctx, first, last);
+        do {
+            ++first;
+        } while (first < end && SORT_LESS(ctx, first, begin));
+        do {
+            --last;
+        } while (last > begin + 1 && !SORT_LESS(ctx, last, begin));
+    }
+
+    pivot_pos = first - 1;
+    if (pivot_pos != begin) {
+        SORT_SWAP(ctx, begin, pivot_pos);
+    }
+    return pivot_pos;
+}
+
+/* Partition around the pivot at begin, with elements equal to the pivot
+   going left. This is used when the pivot equals the element before the
+   range, so the whole left side ends up equal and needs no more sorting. */
+static size_t
+SORT_NAME(partition_left)(SORT_CONTEXT ctx, size_t begin, size_t end)
+{
+    size_t first = begin;
+    size_t last = end;
+
+    do {
+        --last;
+    } while (last > begin && SORT_LESS(ctx, begin, last));
+
+    if (last + 1 == end) {
+        while (first < last) {
+            ++first;
+            if (SORT_LESS(ctx, begin, first)) {
+                break;
+            }
+        }
+    } else {
+        do {
+            ++first;
+        } while (first < end && !SORT_LESS(ctx, begin, first));
+    }
+
+    while (first < last) {
+        SORT_SWAP(ctx, first, last);
+        do {
+            --last;
+        } while (last > begin && SORT_LESS(ctx, begin, last));
+        do {
+            ++first;
+        } while (first < end && !SORT_LESS(ctx, begin, first));
+    }
+
+    if (last != begin) {
+        SORT_SWAP(ctx, begin, last);
+    }
+    return last;
+}
+
+static void
+SORT_NAME(loop)(SORT_CONTEXT ctx, size_t begin, size_t end, int bad_allowed, SDL_bool leftmost)
+{
+    for (;;) {
+        const size_t size = end - begin;
+        const size_t s2 = size / 2;
+        size_t pivot_pos, l_size, r_size;
+        SDL_bool already_partitioned;
+
+        if (size < SORT_INSERTION_THRESHOLD) {
+            SORT_NAME(insertion_sort)(ctx, begin, end);
+            return;
+        }
+
+        /* Move the median of three, or the median of three medians, to begin */
+        if (size > SORT_NINTHER_THRESHOLD) {
+            SORT_NAME(sort3)(ctx, begin, begin + s2, end - 1);
+            SORT_NAME(sort3)(ctx, begin + 1, begin + (s2 - 1), end - 2);
+            SORT_NAME(sort3)(ctx, begin + 2, begin + (s2 + 1), end - 3);
+            SORT_NAME(sort3)(ctx, begin + (s2 - 1), begin + s2, begin + (s2 + 1));
+            SORT_SWAP(ctx, begin, begin + s2);
+        } else {
+            SORT_NAME(sort3)(ctx, begin + s2, begin, end - 1);
+        }
+
+        /* The element before this range was an earlier pivot, so it's no
+           greater than anything here. If it equals this pivot, put all the
+           elements equal to the pivot on the left and only sort the rest. */
+        if (!leftmost && !SORT_LESS(ctx, begin - 1, begin)) {
+            begin = SORT_NAME(partition_left)(ctx, begin, end) + 1;
+            continue;
+        }
+
+        pivot_pos = SORT_NAME(partition_right)(ctx, begin, end, &already_partitioned);
+        l_size = pivot_pos - begin;
+        r_size = end - (pivot_pos + 1);
+
+        if (l_size < size / 8 || r_size < size / 8) {
+            /* After too many bad partitions, fall back to heapsort */
+            if (--bad_allowed == 0) {
+                SORT_NAME(heapsort)(ctx, begin, end);
+                return;
+            }
+
+            /* Shuffle a few elements to break up the pattern */
+            if (l_size >= SORT_INSERTION_THRESHOLD) {
+                SORT_SWAP(ctx, begin, begin + l_size / 4);
+                SORT_SWAP(ctx, pivot_pos - 1, pivot_pos - l_size / 4);
+                if (l_size > SORT_NINTHER_THRESHOLD) {
+                    SORT_SWAP(ctx, begin + 1, begin + (l_size / 4 + 1));
+                    SORT_SWAP(ctx, begin + 2, begin + (l_size / 4 + 2));
+                    SORT_SWAP(ctx, pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    SORT_SWAP(ctx, pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if (r_size >= SORT_INSERTION_THRESHOLD) {
+                SORT_SWAP(ctx, pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                SORT_SWAP(ctx, end - 1, end - r_size / 4);
+                if (r_size > SORT_NINTHER_THRESHOLD) {
+                    SORT_SWAP(ctx, pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    SORT_SWAP(ctx, pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    SORT_SWAP(ctx, end - 2, end - (1 + r_size / 4));
+                    SORT_SWAP(ctx, end - 3, end - (2 + r_size / 4));
+                }
+            }
+        } else if (already_partitioned &&
+                   SORT_NAME(partial_insertion_sort)(ctx, begin, pivot_pos) &&
+                   SORT_NAME(partial_insertion_sort)(ctx, pivot_pos + 1, end)) {
+            /* The range was probably sorted already, and now it is */
+            return;
+        }
+
+        /* Recurse into the smaller side so the stack stays shallow */
+        if (l_size < r_size) {
+            SORT_NAME(loop)(ctx, begin, pivot_pos, bad_allowed, leftmost);
+            begin = pivot_pos + 1;
+            leftmost = SDL_FALSE;
+        } else {
+            SORT_NAME(loop)(ctx, pivot_pos + 1, end, bad_allowed, SDL_FALSE);
+            end = pivot_pos;
+        }
+    }
+}
+
+static void
+SORT_NAME(sort)(SORT_CONTEXT ctx, size_t nmemb)
+{
+    int bad_allowed = 0;
+    size_t n;
+
+    if (nmemb < 2) {
+        return;
+    }
+    for (n = nmemb; n > 1; n >>= 1) {
+        ++bad_allowed;
+    }
+    SORT_NAME(loop)(ctx, 0, nmemb, bad_allowed, SDL_TRUE);
+}
+
+#undef SORT_NAME
+#undef SORT_CONTEXT
+#undef SORT_LESS
+#undef SORT_SWAP
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -27,6 +27,7 @@
 /* This file contains portable string manipulation functions for SDL */
 
 #include "SDL_stdinc.h"
+#include "SDL_cpuinfo.h"
 
 #if defined(_MSC_VER) && _MSC_VER <= 1800
 /* Visual Studio 2013 tries to link with _vacopy in the C runtime. Newer versions do an inline assignment */
@@ -56,6 +57,244 @@ static unsigned UTF8_TrailingBytes(unsigned char c)
         return 0;
 }
 
+/* Scanning 16 bytes at a time, for the functions the C runtime doesn't
+ * provide. Each STRING_* macro turns a byte comparison into a mask with
+ * (1 << STRING_MASK_SHIFT) bits per byte, lowest byte first.
+ *
+ * NUL terminated strings are read with aligned loads, which never cross
+ * into a page the string doesn't touch, and the bytes before the start of
+ * the string are shifted out of the first mask. Reading past the end this
+ * way is fine on the hardware but not to AddressSanitizer.
+ */
+#if defined(__SSE2__) && !defined(SDL_DISABLE_EMMINTRIN_H)
+#define SDL_STRING_VECTOR 1
+typedef __m128i string_vector;
+typedef Uint32 string_mask;
+#define STRING_MASK_SHIFT   0
+#define STRING_LOAD(p)      _mm_load_si128((const __m128i *)(p))
+#define STRING_LOADU(p)     _mm_loadu_si128((const __m128i *)(p))
+#define STRING_SPLAT(c)     _mm_set1_epi8((char)(c))
+#define STRING_EQUAL(v, b)  (string_mask)_mm_movemask_epi8(_mm_cmpeq_epi8(v, b))
+#define STRING_HIGH(v)      (string_mask)_mm_movemask_epi8(v)
+#define STRING_LEAD(v)      (string_mask)_mm_movemask_epi8(_mm_cmpgt_epi8(v, _mm_set1_epi8(-65)))
+#elif defined(__ARM_NEON) && !defined(SDL_DISABLE_ARM_NEON_H)
+#define SDL_STRING_VECTOR 1
+typedef uint8x16_t string_vector;
+typedef Uint64 string_mask;
+#define STRING_MASK_SHIFT   2
+#define STRING_LOAD(p)      vld1q_u8((const uint8_t *)(p))
+#define STRING_LOADU(p)     vld1q_u8((const uint8_t *)(p))
+#define STRING_SPLAT(c)     vdupq_n_u8((uint8_t)(c))
+#define STRING_EQUAL(v, b)  NEON_StringMask(vceqq_u8(v, b))
+#define STRING_HIGH(v)      NEON_StringMask(vcltq_s8(vreinterpretq_s8_u8(v), vdupq_n_s8(0)))
+#define STRING_LEAD(v)      NEON_StringMask(vcgtq_s8(vreinterpretq_s8_u8(v), vdupq_n_s8(-65)))
+
+/* Narrow each 0x00/0xFF byte of a comparison to a nibble of a 64-bit mask */
+static SDL_INLINE string_mask
+NEON_StringMask(uint8x16_t cmp)
+{
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0);
+}
+#endif
+
+#if defined(SDL_STRING_VECTOR) && \
+    (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8))))
+#define STRING_NO_ASAN __attribute__((no_sanitize_address))
+#else
+#define STRING_NO_ASAN
+#endif
+
+#ifdef SDL_STRING_VECTOR
+
+static SDL_INLINE int
+FirstBit32(Uint32 x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return (int)index;
+#else
+    int index = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+static SDL_INLINE int
+CountBits32(Uint32 x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(x);
+#else
+    x = x - ((x >> 1) & 0x55555555);
+    x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+    x = (x + (x >> 4)) & 0x0F0F0F0F;
+    return (int)((x * 0x01010101) >> 24);
+#endif
+}
+
+/* The byte offset of the first match in a non-zero mask */
+static SDL_INLINE size_t
+StringMaskFirst(string_mask mask)
+{
+#if STRING_MASK_SHIFT
+    Uint32 lo = (Uint32)mask;
+    return (size_t)(lo ? FirstBit32(lo) : 32 + FirstBit32((Uint32)(mask >> 32))) >> STRING_MASK_SHIFT;
+#else
+    return (size_t)FirstBit32(mask);
+#endif
+}
+
+/* The number of bytes that matched */
+static SDL_INLINE size_t
+StringMaskCount(string_mask mask)
+{
+#if STRING_MASK_SHIFT
+    return (size_t)(CountBits32((Uint32)mask) + CountBits32((Uint32)(mask >> 32))) >> STRING_MASK_SHIFT;
+#else
+    return (size_t)CountBits32(mask);
+#endif
+}
+
+/* Keep only the matches before the first match in `stop` */
+static SDL_INLINE string_mask
+StringMaskBefore(string_mask mask, string_mask stop)
+{
+    return stop ? (mask & ((stop & (~stop + 1)) - 1)) : mask;
+}
+
+#if !defined(HAVE_STRLEN) || (!defined(HAVE_STRCHR) && !defined(HAVE_INDEX))
+/* Find the first byte that is NUL or c in a NUL terminated string */
+static STRING_NO_ASAN const char *
+StringFindByteOrNUL(const char *string, int c)
+{
+    const Uint8 *p = (const Uint8 *)((uintptr_t)string & ~(uintptr_t)15);
+    const string_vector zero = STRING_SPLAT(0);
+    const string_vector byte = STRING_SPLAT(c);
+    string_vector v = STRING_LOAD(p);
+    string_mask mask = (STRING_EQUAL(v, zero) | STRING_EQUAL(v, byte)) >> (((const Uint8 *)string - p) << STRING_MASK_SHIFT);
+
+    if (mask) {
+        return string + StringMaskFirst(mask);
+    }
+    for (;;) {
+        p += 16;
+        v = STRING_LOAD(p);
+        mask = STRING_EQUAL(v, zero) | STRING_EQUAL(v, byte);
+        if (mask) {
+            return (const char *)p + StringMaskFirst(mask);
+        }
+    }
+}
+#endif /* !HAVE_STRLEN || (!HAVE_STRCHR && !HAVE_INDEX) */
+#endif /* SDL_STRING_VECTOR */
+
+/* Find the first byte equal to c in the first len bytes of buf */
+static STRING_NO_ASAN const void *
+StringFindByte(const void *buf, int c, size_t len)
+{
+#ifdef SDL_STRING_VECTOR
+    const Uint8 *p;
+    size_t offset, index;
+    string_vector byte, v;
+    string_mask mask;
+
+    if (len == 0) {
+        return NULL;
+    }
+    p = (const Uint8 *)((uintptr_t)buf & ~(uintptr_t)15);
+    offset = (size_t)((const Uint8 *)buf - p);
+    byte = STRING_SPLAT(c);
+    v = STRING_LOAD(p);
+    mask = STRING_EQUAL(v, byte) >> (offset << STRING_MASK_SHIFT);
+    if (mask) {
+        index = StringMaskFirst(mask);
+        return (index < len) ? ((const Uint8 *)buf + index) : NULL;
+    }
+    if (len <= 16 - offset) {
+        return NULL;
+    }
+    len -= 16 - offset;
+
+    for (;;) {
+        p += 16;
+        v = STRING_LOAD(p);
+        mask = STRING_EQUAL(v, byte);
+        if (mask) {
+            index = StringMaskFirst(mask);
+            return (index < len) ? (p + index) : NULL;
+        }
+        if (len <= 16) {
+            return NULL;
+        }
+        len -= 16;
+    }
+#else
+    const Uint8 *p = (const Uint8 *)buf;
+    const Uint8 *end = p + len;
+    if (len == (size_t)-1) {
+        end = NULL; /* Scan until found */
+    }
+    for (; p != end; ++p) {
+        if (*p == (Uint8)c) {
+            return p;
+        }
+    }
+    return NULL;
+#endif /* SDL_STRING_VECTOR */
+}
+
+/* The length of a complete and valid UTF-8 sequence at s, or 0 */
+static size_t
+UTF8_ValidSequence(const Uint8 *s, size_t len)
+{
+    Uint8 c = s[0];
+    Uint8 lo = 0x80, hi = 0xBF;
+    size_t need, i;
+
+    if (c < 0x80) {
+        return 1;
+    } else if (c < 0xC2) {
+        return 0; /* Continuation byte or overlong 2 byte sequence */
+    } else if (c < 0xE0) {
+        need = 1;
+    } else if (c < 0xF0) {
+        need = 2;
+        if (c == 0xE0) {
+            lo = 0xA0; /* Overlong */
+        } else if (c == 0xED) {
+            hi = 0x9F; /* Surrogates */
+        }
+    } else if (c < 0xF5) {
+        need = 3;
+        if (c == 0xF0) {
+            lo = 0x90; /* Overlong */
+        } else if (c == 0xF4) {
+            hi = 0x8F; /* Above U+10FFFF */
+        }
+    } else {
+        return 0;
+    }
+
+    if (len <= need) {
+        return 0;
+    }
+    if (s[1] < lo || s[1] > hi) {
+        return 0;
+    }
+    for (i = 2; i <= need; ++i) {
+        if (!UTF8_IsTrailingByte(s[i])) {
+            return 0;
+        }
+    }
+    return need + 1;
+}
+
 #if !defined(HAVE_VSSCANF) || !defined(HAVE_STRTOL)
 static size_t
 SDL_ScanLong(const char *text, int radix, long *valuep)
@@ -420,6 +659,8 @@ SDL_strlen(const char *string)
 {
 #if defined(HAVE_STRLEN)
     return strlen(string);
+#elif defined(SDL_STRING_VECTOR)
+    return (size_t)(StringFindByteOrNUL(string, 0) - string);
 #else
     size_t len = 0;
     while (*string++) {
@@ -637,8 +878,10 @@ SDL_strlcpy(SDL_OUT_Z_CAP(maxlen) char *dst, const char *src, size_t maxlen)
 size_t
 SDL_utf8strlcpy(SDL_OUT_Z_CAP(dst_bytes) char *dst, const char *src, size_t dst_bytes)
 {
-    size_t src_bytes = SDL_strlen(src);
-    size_t bytes = SDL_min(src_bytes, dst_bytes - 1);
+    /* Only look as far as the destination can hold, so copying a long
+       string in pieces doesn't measure the rest of it every time. */
+    const char *end = (const char *)StringFindByte(src, '\0', dst_bytes - 1);
+    size_t bytes = end ? (size_t)(end - src) : (dst_bytes - 1);
     size_t i = 0;
     unsigned char trailing_bytes = 0;
 
@@ -665,10 +908,28 @@ SDL_utf8strlcpy(SDL_OUT_Z_CAP(dst_bytes) char *dst, const char *src, size_t dst_
     return bytes;
 }
 
-size_t
+STRING_NO_ASAN size_t
 SDL_utf8strlen(const char *str)
 {
     size_t retval = 0;
+#ifdef SDL_STRING_VECTOR
+    /* Count the bytes that aren't continuation bytes, 16 at a time */
+    const Uint8 *p = (const Uint8 *)((uintptr_t)str & ~(uintptr_t)15);
+    const size_t shift = (size_t)((const Uint8 *)str - p) << STRING_MASK_SHIFT;
+    const string_vector zero = STRING_SPLAT(0);
+    string_vector v = STRING_LOAD(p);
+    string_mask nul = STRING_EQUAL(v, zero) >> shift;
+    string_mask lead = STRING_LEAD(v) >> shift;
+
+    while (!nul) {
+        retval += StringMaskCount(lead);
+        p += 16;
+        v = STRING_LOAD(p);
+        nul = STRING_EQUAL(v, zero);
+        lead = STRING_LEAD(v);
+    }
+    retval += StringMaskCount(StringMaskBefore(lead, nul));
+#else
     const char *p = str;
     unsigned char ch;
 
@@ -678,10 +939,91 @@ SDL_utf8strlen(const char *str)
             retval++;
         }
     }
-    
+#endif /* SDL_STRING_VECTOR */
     return retval;
 }
 
+STRING_NO_ASAN size_t
+SDL_utf8strnlen(const char *str, size_t bytes)
+{
+    size_t retval = 0;
+#ifdef SDL_STRING_VECTOR
+    const Uint8 *p = (const Uint8 *)((uintptr_t)str & ~(uintptr_t)15);
+    const size_t offset = (size_t)((const Uint8 *)str - p);
+    const string_vector zero = STRING_SPLAT(0);
+    string_vector v = STRING_LOAD(p);
+    string_mask nul = STRING_EQUAL(v, zero) >> (offset << STRING_MASK_SHIFT);
+    string_mask lead = STRING_LEAD(v) >> (offset << STRING_MASK_SHIFT);
+    size_t avail = 16 - offset;
+
+    if (bytes == 0) {
+        return 0;
+    }
+    for (;;) {
+        if (bytes < avail) {
+            /* Stop at the end of the buffer as if it were a NUL */
+            nul |= (string_mask)1 << (bytes << STRING_MASK_SHIFT);
+        }
+        if (nul) {
+            return retval + StringMaskCount(StringMaskBefore(lead, nul));
+        }
+        retval += StringMaskCount(lead);
+        if (bytes == avail) {
+            return retval;
+        }
+        bytes -= avail;
+        avail = 16;
+        p += 16;
+        v = STRING_LOAD(p);
+        nul = STRING_EQUAL(v, zero);
+        lead = STRING_LEAD(v);
+    }
+#else
+    const char *p = str;
+    unsigned char ch;
+
+    while (bytes-- && (ch = *(p++)) != 0) {
+        /* if top two bits are 1 and 0, it's a continuation byte. */
+        if ((ch & 0xc0) != 0x80) {
+            retval++;
+        }
+    }
+    return retval;
+#endif /* SDL_STRING_VECTOR */
+}
+
+size_t
+SDL_utf8valid(const char *str, size_t bytes)
+{
+    const Uint8 *s = (const Uint8 *)str;
+    size_t i = 0;
+
+    while (i < bytes) {
+        size_t end = bytes;
+#ifdef SDL_STRING_VECTOR
+        if (bytes - i >= 16) {
+            /* Skip ASCII 16 bytes at a time, otherwise check the sequences
+               that start in these 16 bytes one by one. */
+            string_mask high = STRING_HIGH(STRING_LOADU(s + i));
+            if (!high) {
+                i += 16;
+                continue;
+            }
+            end = i + 16;
+            i += StringMaskFirst(high);
+        }
+#endif
+        while (i < end) {
+            size_t len = UTF8_ValidSequence(s + i, bytes - i);
+            if (!len) {
+                return i;
+            }
+            i += len;
+        }
+    }
+    return i;
+}
+
 size_t
 SDL_strlcat(SDL_INOUT_Z_CAP(maxlen) char *dst, const char *src, size_t maxlen)
 {
@@ -764,9 +1106,12 @@ SDL_strchr(const char *string, int c)
     return SDL_const_cast(char*,strchr(string, c));
 #elif defined(HAVE_INDEX)
     return SDL_const_cast(char*,index(string, c));
+#elif defined(SDL_STRING_VECTOR)
+    string = StringFindByteOrNUL(string, c);
+    return (*string == (char)c) ? (char *)string : NULL;
 #else
     while (*string) {
-        if (*string == c) {
+        if (*string == (char)c) {
             return (char *) string;
         }
         ++string;
@@ -37,6 +37,7 @@ typedef struct _SDL_Timer
     void *param;
     Uint32 interval;
     Uint32 scheduled;
+    Uint32 order;
     SDL_atomic_t canceled;
     struct _SDL_Timer *next;
 } SDL_Timer;
@@ -48,12 +49,15 @@ typedef struct _SDL_TimerMap
     struct _SDL_TimerMap *next;
 } SDL_TimerMap;
 
-/* The timers are kept in a sorted list */
+/* The timers are kept in a binary heap ordered by scheduling time,
+   and found by ID in a hash table */
 typedef struct {
     /* Data used by the main thread */
     SDL_Thread *thread;
     SDL_atomic_t nextID;
-    SDL_TimerMap *timermap;
+    SDL_TimerMap **timermap;
+    int timermap_size;
+    int timermap_count;
     SDL_mutex *timermap_lock;
 
     /* Padding to separate cache lines between threads */
@@ -65,9 +69,13 @@ typedef struct {
     SDL_Timer *pending;
     SDL_Timer *freelist;
     SDL_atomic_t active;
+    SDL_atomic_t canceled;
 
-    /* List of timers - this is only touched by the timer thread */
-    SDL_Timer *timers;
+    /* Heap of timers - this is only touched by the timer thread */
+    SDL_Timer **timers;
+    int num_timers;
+    int max_timers;
+    Uint32 order;
 } SDL_TimerData;
 
 static SDL_TimerData SDL_timer_data;
@@ -75,28 +83,135 @@ static SDL_TimerData SDL_timer_data;
 /* The idea here is that any thread might add a timer, but a single
  * thread manages the active timer queue, sorted by scheduling time.
  *
- * Timers are removed by simply setting a canceled flag
+ * Timers are removed by simply setting a canceled flag, and the timer
+ * thread drops them from the queue when they come due, or all at once
+ * when they make up half of the queue.
  */
 
+/* Ticks wrap around, so compare the difference. Timers scheduled for the
+   same tick are dispatched in the order they were queued. */
+static SDL_INLINE SDL_bool
+SDL_TimerBefore(const SDL_Timer *a, const SDL_Timer *b)
+{
+    Sint32 diff = (Sint32)(a->scheduled - b->scheduled);
+    if (diff == 0) {
+        diff = (Sint32)(a->order - b->order);
+    }
+    return (diff < 0) ? SDL_TRUE : SDL_FALSE;
+}
+
 static void
-SDL_AddTimerInternal(SDL_TimerData *data, SDL_Timer *timer)
+SDL_SiftTimerUp(SDL_TimerData *data, int i)
 {
-    SDL_Timer *prev, *curr;
+    SDL_Timer **timers = data->timers;
+    SDL_Timer *timer = timers[i];
 
-    prev = NULL;
-    for (curr = data->timers; curr; prev = curr, curr = curr->next) {
-        if ((Sint32)(timer->scheduled-curr->scheduled) < 0) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!SDL_TimerBefore(timer, timers[parent])) {
             break;
         }
+        timers[i] = timers[parent];
+        i = parent;
     }
+    timers[i] = timer;
+}
 
-    /* Insert the timer here! */
-    if (prev) {
-        prev->next = timer;
-    } else {
-        data->timers = timer;
+static void
+SDL_SiftTimerDown(SDL_TimerData *data, int i)
+{
+    SDL_Timer **timers = data->timers;
+    SDL_Timer *timer = timers[i];
+    const int count = data->num_timers;
+
+    for ( ; ; ) {
+        int child = 2 * i + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && SDL_TimerBefore(timers[child + 1], timers[child])) {
+            ++child;
+        }
+        if (!SDL_TimerBefore(timers[child], timer)) {
+            break;
+        }
+        timers[i] = timers[child];
+        i = child;
+    }
+    timers[i] = timer;
+}
+
+static SDL_bool
+SDL_ReserveTimers(SDL_TimerData *data, int count)
+{
+    if (count > data->max_timers) {
+        int max_timers = data->max_timers ? data->max_timers : 64;
+        SDL_Timer **timers;
+
+        while (max_timers < count) {
+            max_timers *= 2;
+        }
+        timers = (SDL_Timer **)SDL_realloc(data->timers, max_timers * sizeof(*timers));
+        if (!timers) {
+            return SDL_FALSE;
+        }
+        data->timers = timers;
+        data->max_timers = max_timers;
+    }
+    return SDL_TRUE;
+}
+
+/* The caller makes sure there's room in the heap */
+static void
+SDL_AddTimerInternal(SDL_TimerData *data, SDL_Timer *timer)
+{
+    timer->order = data->order++;
+    data->timers[data->num_timers] = timer;
+    SDL_SiftTimerUp(data, data->num_timers++);
+}
+
+static void
+SDL_RemoveFirstTimerInternal(SDL_TimerData *data)
+{
+    if (--data->num_timers > 0) {
+        data->timers[0] = data->timers[data->num_timers];
+        SDL_SiftTimerDown(data, 0);
+    }
+}
+
+static void
+SDL_RetireTimer(SDL_TimerData *data, SDL_Timer *timer, SDL_Timer **freelist_head, SDL_Timer **freelist_tail)
+{
+    /* Timers canceled by SDL_RemoveTimer() were counted there */
+    if (!SDL_AtomicCAS(&timer->canceled, 0, 1)) {
+        SDL_AtomicAdd(&data->canceled, -1);
+    }
+
+    timer->next = *freelist_head;
+    *freelist_head = timer;
+    if (!*freelist_tail) {
+        *freelist_tail = timer;
+    }
+}
+
+static void
+SDL_PurgeCanceledTimers(SDL_TimerData *data, SDL_Timer **freelist_head, SDL_Timer **freelist_tail)
+{
+    int i, count = 0;
+
+    for (i = 0; i < data->num_timers; ++i) {
+        SDL_Timer *timer = data->timers[i];
+        if (SDL_AtomicGet(&timer->canceled)) {
+            SDL_RetireTimer(data, timer, freelist_head, freelist_tail);
+        } else {
+            data->timers[count++] = timer;
+        }
+    }
+    data->num_timers = count;
+
+    for (i = count / 2 - 1; i >= 0; --i) {
+        SDL_SiftTimerDown(data, i);
     }
-    timer->next = curr;
 }
 
 static int SDLCALL
@@ -130,8 +245,22 @@ SDL_TimerThread(void *_data)
         }
         SDL_AtomicUnlock(&data->lock);
 
-        /* Sort the pending timers into our list */
+        /* Timers are added to the front of the pending list, put them back
+           in the order they were added so ties are dispatched that way */
+        current = NULL;
         while (pending) {
+            SDL_Timer *next = pending->next;
+            pending->next = current;
+            current = pending;
+            pending = next;
+        }
+        pending = current;
+
+        /* Sort the pending timers into our heap */
+        while (pending) {
+            if (!SDL_ReserveTimers(data, data->num_timers + 1)) {
+                break;
+            }
             current = pending;
             pending = pending->next;
             SDL_AddTimerInternal(data, current);
@@ -139,19 +268,35 @@ SDL_TimerThread(void *_data)
         freelist_head = NULL;
         freelist_tail = NULL;
 
+        /* If we're out of memory, leave the rest for the next cycle */
+        if (pending) {
+            for (current = pending; current->next; current = current->next) {
+                continue;
+            }
+            SDL_AtomicLock(&data->lock);
+            current->next = data->pending;
+            data->pending = pending;
+            SDL_AtomicUnlock(&data->lock);
+        }
+
         /* Check to see if we're still running, after maintenance */
         if (!SDL_AtomicGet(&data->active)) {
             break;
         }
 
+        /* Don't hang on to lots of canceled timers until they're due */
+        if (SDL_AtomicGet(&data->canceled) > data->num_timers / 2) {
+            SDL_PurgeCanceledTimers(data, &freelist_head, &freelist_tail);
+        }
+
         /* Initial delay if there are no timers */
         delay = SDL_MUTEX_MAXWAIT;
 
         tick = SDL_GetTicks();
 
         /* Process all the pending timers for this tick */
-        while (data->timers) {
-            current = data->timers;
+        while (data->num_timers > 0) {
+            current = data->timers[0];
 
             if ((Sint32)(tick-current->scheduled) < 0) {
                 /* Scheduled for the future, wait a bit */
@@ -160,7 +305,7 @@ SDL_TimerThread(void *_data)
             }
 
             /* We're going to do something with this timer */
-            data->timers = current->next;
+            SDL_RemoveFirstTimerInternal(data);
 
             if (SDL_AtomicGet(&current->canceled)) {
                 interval = 0;
@@ -168,21 +313,13 @@ SDL_TimerThread(void *_data)
                 interval = current->callback(current->interval, current->param);
             }
 
-            if (interval > 0) {
-                /* Reschedule this timer */
+            if (interval > 0 && !SDL_AtomicGet(&current->canceled)) {
+                /* Reschedule this timer, it had a place in the heap */
                 current->interval = interval;
                 current->scheduled = tick + interval;
                 SDL_AddTimerInternal(data, current);
             } else {
-                if (!freelist_head) {
-                    freelist_head = current;
-                }
-                if (freelist_tail) {
-                    freelist_tail->next = current;
-                }
-                freelist_tail = current;
-
-                SDL_AtomicSet(&current->canceled, 1);
+                SDL_RetireTimer(data, current, &freelist_head, &freelist_tail);
             }
         }
 
@@ -194,6 +331,9 @@ SDL_TimerThread(void *_data)
         } else {
             delay -= interval;
         }
+        if (pending && delay > 1) {
+            delay = 1;
+        }
 
         /* Note that each time a timer is added, this will return
            immediately, but we process the timers added all at once.
@@ -205,6 +345,42 @@ SDL_TimerThread(void *_data)
     return 0;
 }
 
+/* Timer IDs are handed out in sequence, so the low bits spread them evenly.
+   This must be called with the timermap lock held. */
+static int
+SDL_AddTimerMapEntry(SDL_TimerData *data, SDL_TimerMap *entry)
+{
+    SDL_TimerMap **bucket;
+
+    if (data->timermap_count >= data->timermap_size) {
+        int size = data->timermap_size ? data->timermap_size * 2 : 64;
+        SDL_TimerMap **timermap = (SDL_TimerMap **)SDL_calloc(size, sizeof(*timermap));
+        if (timermap) {
+            int i;
+            for (i = 0; i < data->timermap_size; ++i) {
+                while (data->timermap[i]) {
+                    SDL_TimerMap *rehash = data->timermap[i];
+                    data->timermap[i] = rehash->next;
+                    bucket = &timermap[(Uint32)rehash->timerID & (size - 1)];
+                    rehash->next = *bucket;
+                    *bucket = rehash;
+                }
+            }
+            SDL_free(data->timermap);
+            data->timermap = timermap;
+            data->timermap_size = size;
+        } else if (!data->timermap) {
+            return SDL_OutOfMemory();
+        }
+    }
+
+    bucket = &data->timermap[(Uint32)entry->timerID & (data->timermap_size - 1)];
+    entry->next = *bucket;
+    *bucket = entry;
+    ++data->timermap_count;
+    return 0;
+}
+
 int
 SDL_TimerInit(void)
 {
@@ -243,6 +419,7 @@ SDL_TimerQuit(void)
     SDL_TimerData *data = &SDL_timer_data;
     SDL_Timer *timer;
     SDL_TimerMap *entry;
+    int i;
 
     if (SDL_AtomicCAS(&data->active, 1, 0)) {  /* active? Move to inactive. */
         /* Shutdown the timer thread */
@@ -256,9 +433,16 @@ SDL_TimerQuit(void)
         data->sem = NULL;
 
         /* Clean up the timer entries */
-        while (data->timers) {
-            timer = data->timers;
-            data->timers = timer->next;
+        for (i = 0; i < data->num_timers; ++i) {
+            SDL_free(data->timers[i]);
+        }
+        SDL_free(data->timers);
+        data->timers = NULL;
+        data->num_timers = 0;
+        data->max_timers = 0;
+        while (data->pending) {
+            timer = data->pending;
+            data->pending = timer->next;
             SDL_free(timer);
         }
         while (data->freelist) {
@@ -266,11 +450,19 @@ SDL_TimerQuit(void)
             data->freelist = timer->next;
             SDL_free(timer);
         }
-        while (data->timermap) {
-            entry = data->timermap;
-            data->timermap = entry->next;
-            SDL_free(entry);
+        SDL_AtomicSet(&data->canceled, 0);
+
+        for (i = 0; i < data->timermap_size; ++i) {
+            while (data->timermap[i]) {
+                entry = data->timermap[i];
+                data->timermap[i] = entry->next;
+                SDL_free(entry);
+            }
         }
+        SDL_free(data->timermap);
+        data->timermap = NULL;
+        data->timermap_size = 0;
+        data->timermap_count = 0;
 
         SDL_DestroyMutex(data->timermap_lock);
         data->timermap_lock = NULL;
@@ -283,6 +475,7 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     SDL_TimerData *data = &SDL_timer_data;
     SDL_Timer *timer;
     SDL_TimerMap *entry;
+    int result;
 
     SDL_AtomicLock(&data->lock);
     if (!SDL_AtomicGet(&data->active)) {
@@ -324,10 +517,15 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     entry->timerID = timer->timerID;
 
     SDL_LockMutex(data->timermap_lock);
-    entry->next = data->timermap;
-    data->timermap = entry;
+    result = SDL_AddTimerMapEntry(data, entry);
     SDL_UnlockMutex(data->timermap_lock);
 
+    if (result < 0) {
+        SDL_free(entry);
+        SDL_free(timer);
+        return 0;
+    }
+
     /* Add the timer to the pending list for the timer thread */
     SDL_AtomicLock(&data->lock);
     timer->next = data->pending;
@@ -344,27 +542,33 @@ SDL_bool
 SDL_RemoveTimer(SDL_TimerID id)
 {
     SDL_TimerData *data = &SDL_timer_data;
-    SDL_TimerMap *prev, *entry;
+    SDL_TimerMap *prev, *entry = NULL;
     SDL_bool canceled = SDL_FALSE;
 
     /* Find the timer */
     SDL_LockMutex(data->timermap_lock);
-    prev = NULL;
-    for (entry = data->timermap; entry; prev = entry, entry = entry->next) {
-        if (entry->timerID == id) {
-            if (prev) {
-                prev->next = entry->next;
-            } else {
-                data->timermap = entry->next;
+    if (data->timermap) {
+        SDL_TimerMap **bucket = &data->timermap[(Uint32)id & (data->timermap_size - 1)];
+
+        prev = NULL;
+        for (entry = *bucket; entry; prev = entry, entry = entry->next) {
+            if (entry->timerID == id) {
+                if (prev) {
+                    prev->next = entry->next;
+                } else {
+                    *bucket = entry->next;
+                }
+                --data->timermap_count;
+                break;
             }
-            break;
         }
     }
     SDL_UnlockMutex(data->timermap_lock);
 
     if (entry) {
-        if (!SDL_AtomicGet(&entry->timer->canceled)) {
-            SDL_AtomicSet(&entry->timer->canceled, 1);
+        if (SDL_AtomicCAS(&entry->timer->canceled, 0, 1)) {
+            /* Let the timer thread know it has one more canceled timer */
+            SDL_AtomicIncRef(&data->canceled);
             canceled = SDL_TRUE;
         }
         SDL_free(entry);
@@ -223,14 +223,16 @@ MALI_WarpMouseGlobal(int x, int y)
 
 	if (mouse && mouse->cur_cursor && mouse->focus) {
 
-		SDL_Window *window = mouse->focus;
+		/* Relative mode uses the raw evdev deltas, so there is nothing to
+		   warp, and re-sending motion here would feed back into the deltas. */
+		if (mouse->relative_mode) {
+			return 0;
+		}
 
-		/* Update internal mouse position. */
+		/* Update internal mouse position. The cursor graphic follows it,
+		   calling SDL_WarpMouseInWindow() here would recurse back into us. */
 		SDL_SendMouseMotion(mouse->focus, mouse->mouseID, 0, x, y);
 
-		/* And now update the cursor graphic position on screen. */
-		SDL_WarpMouseInWindow(window, x, y);
-
 	} else {
 		return SDL_SetError("No mouse or current cursor.");
 	}
@@ -277,6 +279,79 @@ MALI_MoveCursor(SDL_Cursor * cursor)
 	}
 }
 
+/* Blend one cursor into the frame with its hotspot at (x,y).
+   The cursor buffer is already alpha-premultiplied, see MALI_CreateCursor(). */
+static void
+MALI_BlendCursor(SDL_Cursor *cursor, int x, int y, Uint32 *pixels, int pitch, int w, int h)
+{
+	MALI_CursorData *curdata;
+	int x0, y0, x1, y1, row, col;
+
+	if (!cursor || !cursor->driverdata) {
+		return;
+	}
+	curdata = (MALI_CursorData *) cursor->driverdata;
+
+	x -= curdata->hot_x;
+	y -= curdata->hot_y;
+
+	/* Clip the cursor rectangle against the frame. */
+	x0 = SDL_max(x, 0);
+	y0 = SDL_max(y, 0);
+	x1 = SDL_min(x + curdata->w, w);
+	y1 = SDL_min(y + curdata->h, h);
+
+	for (row = y0; row < y1; row++) {
+		const Uint32 *src = curdata->buffer + (row - y) * curdata->buffer_pitch + (x0 - x);
+		Uint32 *dst = (Uint32 *)((Uint8 *)pixels + row * pitch) + x0;
+
+		for (col = x0; col < x1; col++, src++, dst++) {
+			const Uint32 s = *src;
+			const Uint32 inv_alpha = 255 - (s >> 24);
+			Uint32 d = *dst;
+
+			if (inv_alpha == 255) {
+				continue;
+			} else if (inv_alpha == 0) {
+				*dst = s;
+				continue;
+			}
+			/* Premultiplied "over": dst = src + dst * (1 - src_alpha), two channels at a time. */
+			d = ((((d & 0x00FF00FF) * inv_alpha) >> 8) & 0x00FF00FF) |
+			    ((((d >> 8) & 0x00FF00FF) * inv_alpha) & 0xFF00FF00);
+			*dst = s + d;
+		}
+	}
+}
+
+void
+MALI_CompositeCursors(Uint32 *pixels, int pitch, int w, int h)
+{
+	SDL_Mouse *mouse = SDL_GetMouse();
+	int i;
+
+	if (!mouse || !mouse->focus || !mouse->cursor_shown || mouse->relative_mode) {
+		return;
+	}
+
+	MALI_BlendCursor(mouse->cur_cursor, mouse->x, mouse->y, pixels, pitch, w, h);
+
+	if (!mouse->multi_pointer) {
+		return;
+	}
+
+	/* Secondary pointers only exist in multi-pointer mode, see SDL_SendMouseMotion(). */
+	for (i = 0; i < mouse->num_sources; i++) {
+		const SDL_MouseInputSource *source = &mouse->sources[i];
+
+		if (!source->has_position || source->mouseID == mouse->mouseID) {
+			continue;
+		}
+		MALI_BlendCursor(source->cursor ? source->cursor : mouse->cur_cursor,
+		                 source->x, source->y, pixels, pitch, w, h);
+	}
+}
+
 #endif /* SDL_VIDEO_DRIVER_KMSDRM */
 
 /* vi: set ts=4 sw=4 expandtab: */
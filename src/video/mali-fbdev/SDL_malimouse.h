@@ -47,6 +47,10 @@ extern void MALI_QuitMouse(_THIS);
 
 extern void MALI_InitCursor(void);
 
+/* Draw the cursor of every visible pointer into an ARGB8888 frame, in one pass.
+   With SDL_HINT_MOUSE_MULTI_POINTER set this includes one cursor per mouse device. */
+extern void MALI_CompositeCursors(Uint32 *pixels, int pitch, int w, int h);
+
 #endif /* SDL_MALI_mouse_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -322,6 +322,69 @@ stdlib_sscanf(void *arg)
   return TEST_COMPLETED;
 }
 
+/**
+ * @brief Call to SDL_utf8strlen, SDL_utf8strnlen, SDL_utf8valid and SDL_utf8strlcpy
+ */
+int
+stdlib_utf8(void *arg)
+{
+  /* "a", U+00E9, U+20AC and U+1F600, 10 bytes */
+  const char *sample = "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+  const char *invalid[] = {
+    "\x80",             /* Continuation byte */
+    "\xc0\xaf",         /* Overlong '/' */
+    "\xe0\x80\xaf",     /* Overlong '/' */
+    "\xed\xa0\x80",     /* Surrogate */
+    "\xf4\x90\x80\x80", /* Above U+10FFFF */
+    "\xf5\x80\x80\x80", /* Invalid lead byte */
+    "\xe2\x82"          /* Truncated */
+  };
+  char text[256];
+  char copy[32];
+  size_t result, expected;
+  int i, offset;
+
+  /* Check at each alignment, with the string spanning several vectors */
+  for (offset = 0; offset < 16; ++offset) {
+    char *str = text + offset;
+    str[0] = '\0';
+    for (i = 0; i < 12; ++i) {
+      SDL_strlcat(str, sample, sizeof(text) - offset);
+    }
+
+    result = SDL_utf8strlen(str);
+    SDLTest_AssertCheck(result == 48, "Check SDL_utf8strlen() at offset %d, expected: 48, got: %d", offset, (int) result);
+
+    result = SDL_utf8strnlen(str, 23);
+    SDLTest_AssertCheck(result == 10, "Check SDL_utf8strnlen() at offset %d, expected: 10, got: %d", offset, (int) result);
+
+    result = SDL_utf8strnlen(str, sizeof(text));
+    SDLTest_AssertCheck(result == 48, "Check SDL_utf8strnlen() past the NUL at offset %d, expected: 48, got: %d", offset, (int) result);
+
+    result = SDL_utf8valid(str, 120);
+    SDLTest_AssertCheck(result == 120, "Check SDL_utf8valid() at offset %d, expected: 120, got: %d", offset, (int) result);
+
+    result = SDL_utf8valid(str, 119);
+    SDLTest_AssertCheck(result == 116, "Check SDL_utf8valid() with a truncated sequence at offset %d, expected: 116, got: %d", offset, (int) result);
+
+    result = SDL_utf8strlcpy(copy, str, sizeof(copy));
+    SDLTest_AssertCheck(result == 31, "Check SDL_utf8strlcpy() at offset %d, expected: 31, got: %d", offset, (int) result);
+
+    result = (size_t) (SDL_strchr(str, '\xf0') - str);
+    SDLTest_AssertCheck(result == 6, "Check SDL_strchr() at offset %d, expected: 6, got: %d", offset, (int) result);
+  }
+  SDLTest_AssertPass("Call to SDL_utf8strlen(), SDL_utf8strnlen(), SDL_utf8valid() and SDL_utf8strlcpy()");
+
+  for (i = 0; i < SDL_arraysize(invalid); ++i) {
+    SDL_snprintf(text, sizeof(text), "0123456789abcdefghij%s", invalid[i]);
+    expected = 20;
+    result = SDL_utf8valid(text, SDL_strlen(text));
+    SDLTest_AssertCheck(result == expected, "Check SDL_utf8valid() with invalid sequence %d, expected: %d, got: %d", i, (int) expected, (int) result);
+  }
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Standard C routine test cases */
@@ -337,9 +400,12 @@ static const SDLTest_TestCaseReference stdlibTest3 =
 static const SDLTest_TestCaseReference stdlibTest4 =
         { (SDLTest_TestCaseFp)stdlib_sscanf, "stdlib_sscanf", "Call to SDL_sscanf", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference stdlibTest5 =
+        { (SDLTest_TestCaseFp)stdlib_utf8, "stdlib_utf8", "Call to the UTF-8 string functions", TEST_ENABLED };
+
 /* Sequence of Standard C routine test cases */
 static const SDLTest_TestCaseReference *stdlibTests[] =  {
-    &stdlibTest1, &stdlibTest2, &stdlibTest3, &stdlibTest4, NULL
+    &stdlibTest1, &stdlibTest2, &stdlibTest3, &stdlibTest4, &stdlibTest5, NULL
 };
 
 /* Standard C routine test suite (global) */
@@ -0,0 +1,159 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Check SDL_crc32() against the original bit-at-a-time algorithm and measure
+   its throughput.
+
+   usage: testcrc32 [--size BYTES] [--iterations N]
+ */
+
+#include "SDL.h"
+
+/* The algorithm SDL_crc32() has always used, one bit at a time */
+static Uint32
+reference_crc32(Uint32 crc, const void *data, size_t len)
+{
+    size_t i;
+    int j;
+
+    for (i = 0; i < len; ++i) {
+        Uint32 r = (Uint8)crc ^ ((const Uint8 *)data)[i];
+        for (j = 0; j < 8; ++j) {
+            r = (r & 1 ? 0 : (Uint32)0xEDB88320L) ^ r >> 1;
+        }
+        crc = (r ^ (Uint32)0xFF000000L) ^ crc >> 8;
+    }
+    return crc;
+}
+
+static int
+check_crc32(const Uint8 *data, size_t size)
+{
+    const char *check = "123456789";
+    size_t offset, len;
+    int failures = 0;
+
+    if (SDL_crc32(0, check, 9) != 0xCBF43926) {
+        SDL_Log("crc32(\"%s\") = 0x%.8x, expected 0xcbf43926\n", check, SDL_crc32(0, check, 9));
+        ++failures;
+    }
+
+    /* Cover every alignment and the edges of the 8, 16 and 64 byte blocks */
+    for (offset = 0; offset < 16; ++offset) {
+        for (len = 0; len <= 300 && offset + len <= size; ++len) {
+            const Uint32 seed = (Uint32)(offset * 0x01000193);
+            const Uint32 expected = reference_crc32(seed, data + offset, len);
+            const Uint32 actual = SDL_crc32(seed, data + offset, len);
+            if (actual != expected) {
+                SDL_Log("crc32 of %d bytes at offset %d = 0x%.8x, expected 0x%.8x\n",
+                        (int)len, (int)offset, actual, expected);
+                ++failures;
+            }
+        }
+    }
+
+    /* A large buffer, and the same buffer in uneven pieces */
+    if (SDL_crc32(0, data, size) != reference_crc32(0, data, size)) {
+        SDL_Log("crc32 of %d bytes doesn't match\n", (int)size);
+        ++failures;
+    } else {
+        Uint32 crc = 0;
+        size_t pos = 0, piece = 1;
+        while (pos < size) {
+            len = SDL_min(piece, size - pos);
+            crc = SDL_crc32(crc, data + pos, len);
+            pos += len;
+            piece = piece * 3 + 1;
+        }
+        if (crc != reference_crc32(0, data, size)) {
+            SDL_Log("crc32 of %d bytes in pieces doesn't match\n", (int)size);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+static void
+benchmark_crc32(const char *name, Uint32 (*crc32)(Uint32, const void *, size_t),
+                const Uint8 *data, size_t size, int iterations)
+{
+    Uint64 start, end;
+    Uint32 crc = 0;
+    double seconds;
+    int i;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        crc = crc32(crc, data, size);
+    }
+    end = SDL_GetPerformanceCounter();
+
+    seconds = (double)(end - start) / SDL_GetPerformanceFrequency();
+    SDL_Log("%s: %d x %d bytes, %.1f MB/s (crc 0x%.8x)\n", name, iterations, (int)size,
+            (double)size * iterations / (1024.0 * 1024.0) / seconds, crc);
+}
+
+static Uint32
+SDL_crc32_wrapper(Uint32 crc, const void *data, size_t len)
+{
+    return SDL_crc32(crc, data, len);
+}
+
+int
+main(int argc, char *argv[])
+{
+    size_t size = 1024 * 1024;
+    int iterations = 100;
+    Uint8 *data;
+    size_t i;
+    int failures;
+    int arg;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (arg = 1; arg < argc; ++arg) {
+        if (SDL_strcmp(argv[arg], "--size") == 0 && argv[arg + 1]) {
+            size = (size_t)SDL_atoi(argv[++arg]);
+        } else if (SDL_strcmp(argv[arg], "--iterations") == 0 && argv[arg + 1]) {
+            iterations = SDL_atoi(argv[++arg]);
+        } else {
+            SDL_Log("Usage: %s [--size BYTES] [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (size < 512 || iterations <= 0) {
+        SDL_Log("Size must be at least 512 and iterations must be positive\n");
+        return 1;
+    }
+
+    data = (Uint8 *)SDL_malloc(size);
+    if (!data) {
+        SDL_Log("Out of memory\n");
+        return 1;
+    }
+    for (i = 0; i < size; ++i) {
+        data[i] = (Uint8)((i * 2654435761u) >> 13);
+    }
+
+    failures = check_crc32(data, size);
+    SDL_Log("crc32 check: %s\n", failures ? "FAILED" : "passed");
+
+    benchmark_crc32("SDL_crc32", SDL_crc32_wrapper, data, size, iterations);
+    benchmark_crc32("bitwise", reference_crc32, data, size, SDL_max(iterations / 20, 1));
+    benchmark_crc32("SDL_crc32 (64 bytes)", SDL_crc32_wrapper, data, 64, (int)(iterations * (size / 64)));
+
+    SDL_free(data);
+    return failures ? 1 : 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
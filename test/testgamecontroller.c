@@ -524,6 +524,7 @@ main(int argc, char *argv[])
     int controller_count = 0;
     int controller_index = 0;
     char guid[64];
+    Uint64 start;
 
     SDL_SetHint(SDL_HINT_ACCELEROMETER_AS_JOYSTICK, "0");
     SDL_SetHint(SDL_HINT_JOYSTICK_HIDAPI_JOY_CONS, "1");
@@ -537,12 +538,26 @@ main(int argc, char *argv[])
     SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
 
     /* Initialize SDL (Note: video is required to start event loop) */
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_JOYSTICK | SDL_INIT_GAMECONTROLLER ) < 0) {
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
         return 1;
     }
 
-    SDL_GameControllerAddMappingsFromFile("gamecontrollerdb.txt");
+    /* Time the controller startup, most of which is loading the built-in mapping database */
+    start = SDL_GetPerformanceCounter();
+    if (SDL_InitSubSystem(SDL_INIT_JOYSTICK | SDL_INIT_GAMECONTROLLER) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    SDL_Log("Game controller subsystem initialized in %.3f ms with %d mappings\n",
+            (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency(),
+            SDL_GameControllerNumMappings());
+
+    start = SDL_GetPerformanceCounter();
+    if (SDL_GameControllerAddMappingsFromFile("gamecontrollerdb.txt") >= 0) {
+        SDL_Log("Loaded gamecontrollerdb.txt in %.3f ms\n",
+                (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency());
+    }
 
     /* Print information about the mappings */
     if (argv[1] && SDL_strcmp(argv[1], "--mappings") == 0) {
@@ -0,0 +1,161 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure the cost of looking up hints that are set with SDL_SetHint(),
+   set in the environment, or not set at all, among many other hints.
+
+   usage: testhintsbench [--iterations N] [--hints N]
+ */
+
+#include "SDL.h"
+
+#define HINT_SET    "SDL_BENCH_HINT_SET"
+#define HINT_ENV    "SDL_BENCH_HINT_ENV"
+#define HINT_UNSET  "SDL_BENCH_HINT_UNSET"
+
+static Uint64 freq;
+
+static double
+ElapsedNS(Uint64 start, Uint64 end)
+{
+    return (double)(end - start) * 1000000000.0 / (double)freq;
+}
+
+static void
+BenchmarkGetHint(const char *name, int iterations)
+{
+    Uint64 start, end;
+    int found = 0;
+    int i;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        if (SDL_GetHint(name)) {
+            ++found;
+        }
+    }
+    end = SDL_GetPerformanceCounter();
+
+    SDL_Log("SDL_GetHint(%s): %.1f ns per lookup%s\n",
+            name, ElapsedNS(start, end) / iterations, found ? "" : " (not found)");
+}
+
+static void
+BenchmarkGetHintBoolean(const char *name, int iterations)
+{
+    Uint64 start, end;
+    int enabled = 0;
+    int i;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        if (SDL_GetHintBoolean(name, SDL_FALSE)) {
+            ++enabled;
+        }
+    }
+    end = SDL_GetPerformanceCounter();
+
+    SDL_Log("SDL_GetHintBoolean(%s): %.1f ns per lookup%s\n",
+            name, ElapsedNS(start, end) / iterations, enabled ? "" : " (false)");
+}
+
+static int
+CheckHints(void)
+{
+    int errors = 0;
+
+    if (!SDL_GetHintBoolean(HINT_SET, SDL_FALSE) || !SDL_GetHintBoolean(HINT_ENV, SDL_FALSE)) {
+        SDL_Log("FAIL: hints aren't set\n");
+        ++errors;
+    }
+
+    /* Changes to the hint and the environment must be seen right away */
+    SDL_SetHint(HINT_SET, "0");
+    if (SDL_GetHintBoolean(HINT_SET, SDL_TRUE)) {
+        SDL_Log("FAIL: SDL_SetHint() change not seen\n");
+        ++errors;
+    }
+    SDL_setenv(HINT_ENV, "0", 1);
+    if (SDL_GetHintBoolean(HINT_ENV, SDL_TRUE)) {
+        SDL_Log("FAIL: SDL_setenv() change not seen\n");
+        ++errors;
+    }
+    if (SDL_SetHint(HINT_ENV, "1") || SDL_strcmp(SDL_GetHint(HINT_ENV), "0") != 0) {
+        SDL_Log("FAIL: environment doesn't override SDL_SetHint()\n");
+        ++errors;
+    }
+    if (!SDL_SetHintWithPriority(HINT_ENV, "1", SDL_HINT_OVERRIDE) || !SDL_GetHintBoolean(HINT_ENV, SDL_FALSE)) {
+        SDL_Log("FAIL: SDL_HINT_OVERRIDE doesn't override the environment\n");
+        ++errors;
+    }
+    if (SDL_GetHint(HINT_UNSET) || SDL_GetHintBoolean(HINT_UNSET, SDL_TRUE) != SDL_TRUE) {
+        SDL_Log("FAIL: unset hint has a value\n");
+        ++errors;
+    }
+    return errors;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int iterations = 1000000;
+    int hints = 100;
+    int errors;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+            iterations = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--hints") == 0 && argv[i + 1]) {
+            hints = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("Usage: %s [--iterations N] [--hints N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations <= 0 || hints < 0) {
+        SDL_Log("Iterations must be positive and hints can't be negative\n");
+        return 1;
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    freq = SDL_GetPerformanceFrequency();
+
+    /* Fill the hint table the way a large application might */
+    for (i = 0; i < hints; ++i) {
+        char name[64];
+        SDL_snprintf(name, sizeof(name), "SDL_BENCH_HINT_%d", i);
+        SDL_SetHint(name, "1");
+    }
+    SDL_SetHint(HINT_SET, "1");
+    SDL_setenv(HINT_ENV, "1", 1);
+
+    SDL_Log("%d lookups with %d other hints set\n", iterations, hints);
+    BenchmarkGetHint(HINT_SET, iterations);
+    BenchmarkGetHint(HINT_ENV, iterations);
+    BenchmarkGetHint(HINT_UNSET, iterations);
+    BenchmarkGetHintBoolean(HINT_SET, iterations);
+    BenchmarkGetHintBoolean(HINT_ENV, iterations);
+
+    errors = CheckHints();
+
+    SDL_Quit();
+    return errors ? 1 : 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -25,6 +25,17 @@ widelen(char *data)
     return len;
 }
 
+static size_t
+widelen16(char *data)
+{
+    size_t len = 0;
+    Uint16 *p = (Uint16 *) data;
+    while (*p++) {
+        ++len;
+    }
+    return len;
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -42,6 +53,10 @@ main(int argc, char *argv[])
         "UCS4",
         "UCS-4",
     };
+    const char *wide_formats[] = {
+        "UTF-16LE",
+        "UTF-32LE",
+    };
 
     const char * fname;
     char buffer[BUFSIZ];
@@ -78,8 +93,23 @@ main(int argc, char *argv[])
             SDL_free(test[0]);
             SDL_free(test[1]);
         }
+        len = (widelen(ucs4) + 1) * 4;
         test[0] = SDL_iconv_string("UTF-8", "UCS-4", ucs4, len);
         SDL_free(ucs4);
+
+        /* Converting straight to and from UTF-8 should give the same result */
+        for (i = 0; i < SDL_arraysize(wide_formats); ++i) {
+            char *wide = SDL_iconv_string(wide_formats[i], "UTF-8", buffer,
+                                          SDL_strlen(buffer) + 1);
+            len = (i == 0) ? (widelen16(wide) + 1) * 2 : (widelen(wide) + 1) * 4;
+            test[1] = SDL_iconv_string("UTF-8", wide_formats[i], wide, len);
+            if (!test[1] || SDL_strcmp(test[1], test[0]) != 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "FAIL: UTF-8 <-> %s\n", wide_formats[i]);
+                ++errors;
+            }
+            SDL_free(wide);
+            SDL_free(test[1]);
+        }
         fputs(test[0], stdout);
         SDL_free(test[0]);
     }
@@ -0,0 +1,206 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure the cost of the input pipeline, from a virtual joystick through
+   the game controller layer to the application's event loop. No hardware
+   is needed, so this can run on build machines.
+
+   usage: testjoystickbench [--iterations N] [--rate HZ] [--seconds S]
+ */
+
+#include "SDL.h"
+
+/* The inputs covered by the mapping in main() */
+#define NUM_AXES    6
+#define NUM_BUTTONS 15
+
+static Uint64 freq;
+
+static double
+ElapsedNS(Uint64 start, Uint64 end)
+{
+    return (double)(end - start) * 1000000000.0 / (double)freq;
+}
+
+static void
+CountEvents(int *joystick_events, int *controller_events)
+{
+    SDL_Event event;
+
+    while (SDL_PollEvent(&event)) {
+        switch (event.type) {
+        case SDL_JOYAXISMOTION:
+        case SDL_JOYBUTTONDOWN:
+        case SDL_JOYBUTTONUP:
+            ++*joystick_events;
+            break;
+        case SDL_CONTROLLERAXISMOTION:
+        case SDL_CONTROLLERBUTTONDOWN:
+        case SDL_CONTROLLERBUTTONUP:
+            ++*controller_events;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/* Set one input at a time and poll the events it generates */
+static void
+BenchmarkDirect(SDL_Joystick *joystick, int iterations)
+{
+    int joystick_events = 0;
+    int controller_events = 0;
+    Uint64 start, end;
+    int i;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        if (i % 2) {
+            SDL_JoystickSetVirtualButton(joystick, (i / 2) % NUM_BUTTONS, (i / 2 / NUM_BUTTONS) % 2);
+        } else {
+            SDL_JoystickSetVirtualAxis(joystick, (i / 2) % NUM_AXES, ((i / 2 / NUM_AXES) % 2) ? 16384 : -16384);
+        }
+        CountEvents(&joystick_events, &controller_events);
+    }
+    end = SDL_GetPerformanceCounter();
+
+    SDL_Log("direct: %d inputs, %d joystick events, %d controller events, %.0f ns per input\n",
+            iterations, joystick_events, controller_events, ElapsedNS(start, end) / iterations);
+}
+
+/* Play a script at a fixed rate and poll once per millisecond */
+static void
+BenchmarkPlayback(SDL_Joystick *joystick, int rate, int seconds)
+{
+    SDL_VirtualJoystickInput script[2 * (NUM_AXES + NUM_BUTTONS)];
+    int joystick_events = 0;
+    int controller_events = 0;
+    Uint64 busy = 0;
+    Uint64 start, end, now;
+    int i, n = 0;
+
+    for (i = 0; i < NUM_AXES; ++i) {
+        script[n].type = SDL_JOYAXISMOTION;
+        script[n].index = (Uint8)i;
+        script[n].value = 16384;
+        ++n;
+        script[n].type = SDL_JOYAXISMOTION;
+        script[n].index = (Uint8)i;
+        script[n].value = -16384;
+        ++n;
+    }
+    for (i = 0; i < NUM_BUTTONS; ++i) {
+        script[n].type = SDL_JOYBUTTONDOWN;
+        script[n].index = (Uint8)i;
+        script[n].value = 0;
+        ++n;
+        script[n].type = SDL_JOYBUTTONUP;
+        script[n].index = (Uint8)i;
+        script[n].value = 0;
+        ++n;
+    }
+
+    if (SDL_JoystickPlayVirtual(joystick, script, n, rate, SDL_TRUE) < 0) {
+        SDL_Log("Couldn't play script: %s\n", SDL_GetError());
+        return;
+    }
+
+    start = SDL_GetPerformanceCounter();
+    end = start + (Uint64)seconds * freq;
+    do {
+        SDL_Delay(1);
+        now = SDL_GetPerformanceCounter();
+        CountEvents(&joystick_events, &controller_events);
+        busy += SDL_GetPerformanceCounter() - now;
+    } while (SDL_GetPerformanceCounter() < end);
+
+    SDL_JoystickPlayVirtual(joystick, NULL, 0, 0, SDL_FALSE);
+
+    SDL_Log("playback: %d Hz for %d s, %d joystick events, %d controller events, %.0f ns per event, %.2f%% of the time in the event loop\n",
+            rate, seconds, joystick_events, controller_events,
+            controller_events ? ElapsedNS(0, busy) / controller_events : 0.0,
+            100.0 * (double)busy / (double)(SDL_GetPerformanceCounter() - start));
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_GameController *gamecontroller;
+    SDL_Joystick *joystick;
+    char guid[64];
+    char mapping[512];
+    int iterations = 100000;
+    int rate = 1000;
+    int seconds = 2;
+    int device_index;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+            iterations = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--rate") == 0 && argv[i + 1]) {
+            rate = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--seconds") == 0 && argv[i + 1]) {
+            seconds = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("Usage: %s [--iterations N] [--rate HZ] [--seconds S]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations <= 0 || rate <= 0 || seconds <= 0) {
+        SDL_Log("Iterations, rate and seconds must be positive\n");
+        return 1;
+    }
+
+    if (SDL_Init(SDL_INIT_GAMECONTROLLER) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    freq = SDL_GetPerformanceFrequency();
+
+    device_index = SDL_JoystickAttachVirtual(SDL_JOYSTICK_TYPE_GAMECONTROLLER, NUM_AXES, NUM_BUTTONS, 0);
+    if (device_index < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't attach virtual joystick: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    /* Map the virtual joystick inputs straight to the controller inputs */
+    SDL_JoystickGetGUIDString(SDL_JoystickGetDeviceGUID(device_index), guid, sizeof(guid));
+    SDL_snprintf(mapping, sizeof(mapping),
+                 "%s,Virtual Benchmark,a:b0,b:b1,x:b2,y:b3,back:b4,guide:b5,start:b6,leftstick:b7,rightstick:b8,"
+                 "leftshoulder:b9,rightshoulder:b10,dpup:b11,dpdown:b12,dpleft:b13,dpright:b14,"
+                 "leftx:a0,lefty:a1,rightx:a2,righty:a3,lefttrigger:a4,righttrigger:a5,", guid);
+    SDL_GameControllerAddMapping(mapping);
+
+    gamecontroller = SDL_GameControllerOpen(device_index);
+    if (!gamecontroller) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't open game controller: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+    joystick = SDL_GameControllerGetJoystick(gamecontroller);
+
+    BenchmarkDirect(joystick, iterations);
+    BenchmarkPlayback(joystick, rate, seconds);
+
+    SDL_GameControllerClose(gamecontroller);
+    SDL_JoystickDetachVirtual(device_index);
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
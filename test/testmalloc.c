@@ -0,0 +1,285 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure SDL_malloc() and SDL_free() throughput from several threads at
+   once, both with each thread freeing its own memory and with memory handed
+   from one thread to another, the way events and audio buffers are.
+
+   If SDL was built with SDL_MEMORY_STATS, the allocation statistics are
+   printed at the end.
+
+   usage: testmalloc [--threads N] [--iterations N]
+ */
+
+#include "SDL.h"
+
+#define NUM_SLOTS   256
+#define QUEUE_SIZE  1024
+
+typedef struct
+{
+    int iterations;
+    Uint32 seed;
+} WorkerData;
+
+/* A single producer, single consumer queue of allocations */
+typedef struct
+{
+    void *items[QUEUE_SIZE];
+    SDL_atomic_t head;
+    SDL_atomic_t tail;
+    int iterations;
+} HandoffQueue;
+
+static Uint32
+NextRandom(Uint32 *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+/* Allocate and free blocks of mixed sizes in random order */
+static int SDLCALL
+ChurnThread(void *arg)
+{
+    WorkerData *data = (WorkerData *)arg;
+    void *slots[NUM_SLOTS];
+    int i;
+
+    SDL_zeroa(slots);
+    for (i = 0; i < data->iterations; ++i) {
+        const Uint32 r = NextRandom(&data->seed);
+        const int slot = r % NUM_SLOTS;
+        if (slots[slot]) {
+            SDL_free(slots[slot]);
+            slots[slot] = NULL;
+        } else {
+            /* Mostly small blocks, with the occasional large one */
+            const size_t size = (r & 0x1F00) ? (16 + (r >> 8) % 256) : (4096 + (r >> 8) % 65536);
+            slots[slot] = SDL_malloc(size);
+            if (slots[slot]) {
+                *(Uint8 *)slots[slot] = (Uint8)i;
+            }
+        }
+    }
+    for (i = 0; i < NUM_SLOTS; ++i) {
+        SDL_free(slots[i]);
+    }
+    return 0;
+}
+
+static int SDLCALL
+IdleThread(void *arg)
+{
+    return 0;
+}
+
+static int SDLCALL
+ProducerThread(void *arg)
+{
+    HandoffQueue *queue = (HandoffQueue *)arg;
+    Uint32 seed = 1;
+    int i;
+
+    for (i = 0; i < queue->iterations; ++i) {
+        const int head = SDL_AtomicGet(&queue->head);
+        while (head - SDL_AtomicGet(&queue->tail) == QUEUE_SIZE) {
+            SDL_Delay(0);
+        }
+        queue->items[head % QUEUE_SIZE] = SDL_malloc(16 + NextRandom(&seed) % 512);
+        SDL_AtomicSet(&queue->head, head + 1);
+    }
+    return 0;
+}
+
+static int SDLCALL
+ConsumerThread(void *arg)
+{
+    HandoffQueue *queue = (HandoffQueue *)arg;
+    int i;
+
+    for (i = 0; i < queue->iterations; ++i) {
+        const int tail = SDL_AtomicGet(&queue->tail);
+        while (SDL_AtomicGet(&queue->head) == tail) {
+            SDL_Delay(0);
+        }
+        SDL_free(queue->items[tail % QUEUE_SIZE]);
+        SDL_AtomicSet(&queue->tail, tail + 1);
+    }
+    return 0;
+}
+
+static const char *tag_names[SDL_NUM_MEMORY_TAGS] = {
+    "other", "application", "events", "audio", "render", "video", "joystick"
+};
+
+static void
+PrintMemoryStats(void)
+{
+    SDL_MemoryStats stats;
+    SDL_MemorySiteStats sites[5];
+    int i, num_sites;
+
+    if (SDL_GetMemoryStats(&stats) < 0) {
+        SDL_Log("No memory statistics: %s\n", SDL_GetError());
+        return;
+    }
+
+    SDL_Log("%.1f KB in use, %.1f KB at peak\n",
+            stats.bytes_in_use / 1024.0, stats.peak_bytes_in_use / 1024.0);
+    for (i = 0; i < SDL_NUM_MEMORY_TAGS; ++i) {
+        const SDL_MemoryTagStats *tag = &stats.tags[i];
+        SDL_Log("  %-12s %10" SDL_PRIu64 " allocations, %10" SDL_PRIu64 " frees, %.1f KB in use, %.1f KB at peak\n",
+                tag_names[i], tag->allocations, tag->frees,
+                tag->bytes_in_use / 1024.0, tag->peak_bytes_in_use / 1024.0);
+    }
+    for (i = 0; i < SDL_MEMORY_HISTOGRAM_BUCKETS; ++i) {
+        if (stats.histogram[i]) {
+            SDL_Log("  %s%8d bytes: %" SDL_PRIu64 "\n",
+                    (i == SDL_MEMORY_HISTOGRAM_BUCKETS - 1) ? "> " : "<=",
+                    16 << ((i == SDL_MEMORY_HISTOGRAM_BUCKETS - 1) ? (i - 1) : i), stats.histogram[i]);
+        }
+    }
+
+    num_sites = SDL_GetMemorySites(sites, SDL_arraysize(sites));
+    for (i = 0; i < num_sites; ++i) {
+        SDL_Log("  %s:%d (%s): %" SDL_PRIu64 " allocations\n",
+                sites[i].file, sites[i].line, tag_names[sites[i].tag], sites[i].allocations);
+    }
+}
+
+static double
+Seconds(Uint64 start)
+{
+    return (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+static void
+BenchmarkChurn(int num_threads, int iterations)
+{
+    SDL_Thread **threads = (SDL_Thread **)SDL_calloc(num_threads, sizeof(*threads));
+    WorkerData *data = (WorkerData *)SDL_calloc(num_threads, sizeof(*data));
+    Uint64 start;
+    double seconds;
+    int i;
+
+    if (!threads || !data) {
+        SDL_Log("Out of memory\n");
+        SDL_free(threads);
+        SDL_free(data);
+        return;
+    }
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < num_threads; ++i) {
+        data[i].iterations = iterations;
+        data[i].seed = (Uint32)(i + 1);
+        threads[i] = SDL_CreateThread(ChurnThread, "Churn", &data[i]);
+    }
+    for (i = 0; i < num_threads; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    seconds = Seconds(start);
+
+    SDL_Log("churn: %d threads x %d operations, %.0f ns per operation, %.1f M operations/s\n",
+            num_threads, iterations, seconds * 1e9 / iterations,
+            (double)num_threads * iterations / seconds / 1e6);
+
+    SDL_free(threads);
+    SDL_free(data);
+}
+
+static void
+BenchmarkHandoff(int num_pairs, int iterations)
+{
+    SDL_Thread **threads = (SDL_Thread **)SDL_calloc(num_pairs * 2, sizeof(*threads));
+    HandoffQueue *queues = (HandoffQueue *)SDL_calloc(num_pairs, sizeof(*queues));
+    Uint64 start;
+    double seconds;
+    int i;
+
+    if (!threads || !queues) {
+        SDL_Log("Out of memory\n");
+        SDL_free(threads);
+        SDL_free(queues);
+        return;
+    }
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < num_pairs; ++i) {
+        queues[i].iterations = iterations;
+        threads[i * 2] = SDL_CreateThread(ProducerThread, "Producer", &queues[i]);
+        threads[i * 2 + 1] = SDL_CreateThread(ConsumerThread, "Consumer", &queues[i]);
+    }
+    for (i = 0; i < num_pairs * 2; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    seconds = Seconds(start);
+
+    SDL_Log("handoff: %d thread pairs x %d blocks, %.1f M blocks/s\n",
+            num_pairs, iterations, (double)num_pairs * iterations / seconds / 1e6);
+
+    SDL_free(threads);
+    SDL_free(queues);
+}
+
+int
+main(int argc, char *argv[])
+{
+    int num_threads = 4;
+    int iterations = 1000000;
+    int allocations;
+    int arg;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (arg = 1; arg < argc; ++arg) {
+        if (SDL_strcmp(argv[arg], "--threads") == 0 && argv[arg + 1]) {
+            num_threads = SDL_atoi(argv[++arg]);
+        } else if (SDL_strcmp(argv[arg], "--iterations") == 0 && argv[arg + 1]) {
+            iterations = SDL_atoi(argv[++arg]);
+        } else {
+            SDL_Log("Usage: %s [--threads N] [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (num_threads <= 0 || iterations <= 0) {
+        SDL_Log("Threads and iterations must be positive\n");
+        return 1;
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    /* The thread subsystem allocates its globals when the first thread is
+       created, so start one before counting allocations */
+    SDL_WaitThread(SDL_CreateThread(IdleThread, "WarmUp", NULL), NULL);
+    allocations = SDL_GetNumAllocations();
+
+    BenchmarkChurn(1, iterations);
+    BenchmarkChurn(num_threads, iterations);
+    BenchmarkHandoff(SDL_max(num_threads / 2, 1), iterations);
+
+    if (SDL_GetNumAllocations() != allocations) {
+        SDL_Log("%d allocations leaked\n", SDL_GetNumAllocations() - allocations);
+    }
+
+    PrintMemoryStats();
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -20,15 +20,37 @@ num_compare(const void *_a, const void *_b)
     return (a < b) ? -1 : ((a > b) ? 1 : 0);
 }
 
+static int
+Uint32_compare(const void *_a, const void *_b)
+{
+    const Uint32 a = *((const Uint32 *) _a);
+    const Uint32 b = *((const Uint32 *) _b);
+    return (a < b) ? -1 : ((a > b) ? 1 : 0);
+}
+
 static void
 test_sort(const char *desc, int *nums, const int arraylen)
 {
+    static Uint32 values[1024 * 100];
+    static float floats[1024 * 100];
+    static SDL_SortKey keys[1024 * 100];
     int i;
     int prev;
 
     SDL_Log("test: %s arraylen=%d", desc, arraylen);
 
+    /* Sort copies with the typed functions too, as unsigned values */
+    for (i = 0; i < arraylen; i++) {
+        values[i] = (Uint32)nums[i] ^ 0x80000000;
+        floats[i] = (float)nums[i];
+        keys[i].key = (Uint32)nums[i] ^ 0x80000000;
+        keys[i].index = i;
+    }
+
     SDL_qsort(nums, arraylen, sizeof (nums[0]), num_compare);
+    SDL_qsort_Uint32(values, arraylen);
+    SDL_qsort_float(floats, arraylen);
+    SDL_qsort_keys(keys, arraylen);
 
     prev = nums[0];
     for (i = 1; i < arraylen; i++) {
@@ -39,6 +61,114 @@ test_sort(const char *desc, int *nums, const int arraylen)
         }
         prev = val;
     }
+    for (i = 0; i < arraylen; i++) {
+        if (values[i] != ((Uint32)nums[i] ^ 0x80000000)) {
+            SDL_Log("Uint32 sort is broken!");
+            return;
+        }
+        if (floats[i] != (float)nums[i]) {
+            SDL_Log("float sort is broken!");
+            return;
+        }
+        if (keys[i].key != ((Uint32)nums[i] ^ 0x80000000) ||
+            (i > 0 && keys[i].key == keys[i - 1].key && keys[i].index < keys[i - 1].index)) {
+            SDL_Log("key sort is broken!");
+            return;
+        }
+    }
+}
+
+typedef enum
+{
+    PATTERN_RANDOM,
+    PATTERN_SORTED,
+    PATTERN_REVERSED,
+    PATTERN_FEW_UNIQUE,
+    PATTERN_ORGAN_PIPE,
+    NUM_PATTERNS
+} Pattern;
+
+static const char *pattern_names[NUM_PATTERNS] = {
+    "random", "sorted", "reversed", "few unique", "organ pipe"
+};
+
+static void
+fill_pattern(Uint32 *values, int count, Pattern pattern, SDLTest_RandomContext *rndctx)
+{
+    int i;
+
+    for (i = 0; i < count; i++) {
+        switch (pattern) {
+        case PATTERN_RANDOM:
+            values[i] = (Uint32)SDLTest_RandomInt(rndctx);
+            break;
+        case PATTERN_SORTED:
+            values[i] = (Uint32)i;
+            break;
+        case PATTERN_REVERSED:
+            values[i] = (Uint32)(count - i);
+            break;
+        case PATTERN_FEW_UNIQUE:
+            values[i] = (Uint32)SDLTest_RandomInt(rndctx) % 16;
+            break;
+        case PATTERN_ORGAN_PIPE:
+            values[i] = (Uint32)((i < count / 2) ? i : (count - i));
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static double
+elapsed_ms(Uint64 start)
+{
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+/* Time the generic and typed sorts on a large array of each pattern */
+static void
+benchmark_sort(int count, SDLTest_RandomContext *rndctx)
+{
+    Uint32 *values = (Uint32 *)SDL_malloc(count * sizeof(*values));
+    SDL_SortKey *keys = (SDL_SortKey *)SDL_malloc(count * sizeof(*keys));
+    Uint64 start;
+    double generic, typed, keyed;
+    int pattern, i;
+
+    if (!values || !keys) {
+        SDL_Log("Out of memory\n");
+        SDL_free(values);
+        SDL_free(keys);
+        return;
+    }
+
+    for (pattern = 0; pattern < NUM_PATTERNS; pattern++) {
+        fill_pattern(values, count, (Pattern)pattern, rndctx);
+        start = SDL_GetPerformanceCounter();
+        SDL_qsort(values, count, sizeof(*values), Uint32_compare);
+        generic = elapsed_ms(start);
+
+        fill_pattern(values, count, (Pattern)pattern, rndctx);
+        start = SDL_GetPerformanceCounter();
+        SDL_qsort_Uint32(values, count);
+        typed = elapsed_ms(start);
+
+        fill_pattern(values, count, (Pattern)pattern, rndctx);
+        for (i = 0; i < count; i++) {
+            keys[i].key = values[i];
+            keys[i].index = i;
+        }
+        start = SDL_GetPerformanceCounter();
+        SDL_qsort_keys(keys, count);
+        keyed = elapsed_ms(start);
+
+        SDL_Log("benchmark: %-10s %d elements: SDL_qsort %.2f ms, SDL_qsort_Uint32 %.2f ms, SDL_qsort_keys %.2f ms",
+                pattern_names[pattern], count, generic, typed, keyed);
+    }
+
+    SDL_free(values);
+    SDL_free(keys);
 }
 
 int
@@ -47,8 +177,17 @@ main(int argc, char *argv[])
     static int nums[1024 * 100];
     static const int itervals[] = { SDL_arraysize(nums), 12 };
     int iteration;
+    int benchmark = 0;
     SDLTest_RandomContext rndctx;
 
+    if (argc > 1 && SDL_strcmp(argv[1], "--benchmark") == 0) {
+        benchmark = 1000000;
+        if (argc > 2 && SDL_isdigit(argv[2][0])) {
+            benchmark = SDL_atoi(argv[2]);
+        }
+        argc = 1;
+    }
+
     if (argc > 1)
     {
         int success;
@@ -97,6 +236,20 @@ main(int argc, char *argv[])
             nums[i] = SDLTest_RandomInt(&rndctx);
         }
         test_sort("random sorted", nums, arraylen);
+
+        for (i = 0; i < arraylen; i++) {
+            nums[i] = SDLTest_RandomInt(&rndctx) % 8;
+        }
+        test_sort("few unique", nums, arraylen);
+
+        for (i = 0; i < arraylen; i++) {
+            nums[i] = (i < arraylen / 2) ? i : (arraylen - i);
+        }
+        test_sort("organ pipe", nums, arraylen);
+    }
+
+    if (benchmark > 0) {
+        benchmark_sort(benchmark, &rndctx);
     }
 
     return 0;
@@ -20,8 +20,13 @@
 #include "SDL.h"
 
 #define DEFAULT_RESOLUTION  1
+#define NUM_TIMERS          10000
 
 static int ticks = 0;
+static SDL_TimerID ids[NUM_TIMERS];
+static SDL_atomic_t fired;
+static int last_fired = -1;
+static SDL_bool out_of_order = SDL_FALSE;
 
 static Uint32 SDLCALL
 ticktock(Uint32 interval, void *param)
@@ -37,6 +42,26 @@ callback(Uint32 interval, void *param)
     return interval;
 }
 
+static Uint32 SDLCALL
+timeout(Uint32 interval, void *param)
+{
+    return 0;
+}
+
+static Uint32 SDLCALL
+ordered(Uint32 interval, void *param)
+{
+    int index = (int) (uintptr_t) param;
+
+    /* Only the timer thread calls this, so last_fired needs no lock */
+    if (index < last_fired) {
+        out_of_order = SDL_TRUE;
+    }
+    last_fired = index;
+    SDL_AtomicIncRef(&fired);
+    return 0;
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -116,6 +141,34 @@ main(int argc, char *argv[])
     SDL_RemoveTimer(t2);
     SDL_RemoveTimer(t3);
 
+    /* Test lots of timers, like network timeouts that are mostly canceled */
+    SDL_Log("Adding and removing %d timers...\n", NUM_TIMERS);
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_TIMERS; ++i) {
+        ids[i] = SDL_AddTimer(60 * 1000 + i, timeout, NULL);
+    }
+    now = SDL_GetPerformanceCounter();
+    SDL_Log("Adding %d timers took %f ms\n", NUM_TIMERS, (double)((now - start)*1000) / SDL_GetPerformanceFrequency());
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_TIMERS; ++i) {
+        if (!SDL_RemoveTimer(ids[i])) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Could not remove timer %d\n", i);
+        }
+    }
+    now = SDL_GetPerformanceCounter();
+    SDL_Log("Removing %d timers took %f ms\n", NUM_TIMERS, (double)((now - start)*1000) / SDL_GetPerformanceFrequency());
+
+    /* Timers should fire in order of their scheduled time */
+    SDL_Log("Firing %d timers...\n", NUM_TIMERS);
+    for (i = 0; i < NUM_TIMERS; ++i) {
+        ids[i] = SDL_AddTimer(100 + i / 100, ordered, (void *) (uintptr_t) i);
+    }
+    SDL_Delay(1000);
+    if (SDL_AtomicGet(&fired) != NUM_TIMERS || out_of_order) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%d of %d timers fired%s\n",
+                     SDL_AtomicGet(&fired), NUM_TIMERS, out_of_order ? ", out of order" : "");
+    }
+
     start = SDL_GetPerformanceCounter();
     for (i = 0; i < 1000000; ++i) {
         ticktock(0, NULL);